@@ -1,397 +1,1039 @@
-// Convert DMD CodeView debug information to PDB files
-// Copyright (c) 2009-2010 by Rainer Schuetze, All Rights Reserved
-//
-// License for redistribution is given by the Artistic License 2.0
-// see file LICENSE for further details
-
-#include "PEImage.h"
-
-extern "C" {
-#include "mscvpdb.h"
-}
-
-#include <stdio.h>
-#include <io.h>
-#include <fcntl.h>
-#include <ctype.h>
-#include <direct.h>
-#include <share.h>
-#include <sys/stat.h>
-
-#ifdef UNICODE
-#define T_sopen	_wsopen
-#define T_open	_wopen
-#else
-#define T_sopen	sopen
-#define T_open	open
-#endif
-
-///////////////////////////////////////////////////////////////////////
-PEImage::PEImage(const TCHAR* iname)
-: dump_base(0)
-, dump_total_len(0)
-, dirHeader(0)
-, hdr32(0)
-, hdr64(0)
-, fd(-1)
-, debug_aranges(0)
-, debug_pubnames(0)
-, debug_pubtypes(0)
-, debug_info(0)
-, debug_abbrev(0)
-, debug_line(0)
-, debug_frame(0)
-, debug_str(0)
-, debug_loc(0)
-, debug_ranges(0)
-, codeSegment(0)
-, reloc(0)
-, reloc_length(0)
-{
-	if(iname)
-		load(iname);
-}
-
-PEImage::~PEImage()
-{
-	if(fd != -1)
-		close(fd);
-	if(dump_base)
-		free_aligned(dump_base);
-}
-
-///////////////////////////////////////////////////////////////////////
-bool PEImage::load(const TCHAR* iname)
-{
-	if (fd != -1)
-		return setError("file already open");
-
-	fd = T_sopen(iname, O_RDONLY | O_BINARY, SH_DENYWR);
-	if (fd == -1) 
-		return setError("Can't open file");
-
-	struct stat s;
-	if (fstat(fd, &s) < 0)
-		return setError("Can't get size");
-	dump_total_len = s.st_size;
-
-	dump_base = alloc_aligned(dump_total_len, 0x1000);
-	if (!dump_base)
-		return setError("Out of memory");
-	if (read(fd, dump_base, dump_total_len) != dump_total_len) 
-		return setError("Cannot read file");
-	
-
-	close(fd);
-	fd = -1;
-	return initCVPtr(true) || initDWARFPtr(true);
-}
-
-///////////////////////////////////////////////////////////////////////
-bool PEImage::save(const TCHAR* oname)
-{
-	if (fd != -1)
-		return setError("file already open");
-
-	if (!dump_base)
-		return setError("no data to dump");
-
-	fd = T_open(oname, O_WRONLY | O_CREAT | O_BINARY | O_TRUNC, S_IREAD | S_IWRITE | S_IEXEC);
-	if (fd == -1) 
-		return setError("Can't create file");
-
-	if (write(fd, dump_base, dump_total_len) != dump_total_len) 
-		return setError("Cannot write file");
-
-	close(fd);
-	fd = -1;
-	return true;
-}
-
-///////////////////////////////////////////////////////////////////////
-bool PEImage::replaceDebugSection (const void* data, int datalen, bool initCV)
-{
-	// append new debug directory to data
-	IMAGE_DEBUG_DIRECTORY debugdir;
-	if(dbgDir)
-		debugdir = *dbgDir;
-	else
-		memset(&debugdir, 0, sizeof(debugdir));
-	int xdatalen = datalen + sizeof(debugdir);
-
-	// assume there is place for another section because of section alignment
-	int s;
-	DWORD lastVirtualAddress = 0;
-	int cntSections = countSections();
-	for(s = 0; s < cntSections; s++)
-	{
-		if (strcmp ((char*) sec [s].Name, ".debug") == 0)
-		{
-			if (s == cntSections - 1)
-			{
-				dump_total_len = sec[s].PointerToRawData;
-				break;
-			}
-			strcpy ((char*) sec [s].Name, ".ddebug");
-			printf("warning: .debug not last section, cannot remove section\n");
-		}
-		lastVirtualAddress = sec [s].VirtualAddress + sec[s].Misc.VirtualSize;
-	}
-
-	int align = IMGHDR(OptionalHeader.FileAlignment);
-	int align_len = xdatalen;
-	int fill = 0;
-
-	if (align > 0)
-	{
-		fill = (align - (dump_total_len % align)) % align;
-		align_len = ((xdatalen + align - 1) / align) * align;
-	}
-	char* newdata = (char*) alloc_aligned(dump_total_len + fill + xdatalen, 0x1000);
-	if(!newdata)
-		return setError("cannot alloc new image");
-
-	int salign_len = xdatalen;
-	align = IMGHDR(OptionalHeader.SectionAlignment);
-	if (align > 0)
-	{
-		lastVirtualAddress = ((lastVirtualAddress + align - 1) / align) * align;
-		salign_len = ((xdatalen + align - 1) / align) * align;
-	}
-
-	strcpy((char*) sec[s].Name, ".debug");
-	sec[s].Misc.VirtualSize = align_len; // union with PhysicalAddress;
-	sec[s].VirtualAddress = lastVirtualAddress;
-	sec[s].SizeOfRawData = xdatalen;
-	sec[s].PointerToRawData = dump_total_len + fill;
-	sec[s].PointerToRelocations = 0;
-	sec[s].PointerToLinenumbers = 0;
-	sec[s].NumberOfRelocations = 0;
-	sec[s].NumberOfLinenumbers = 0;
-	sec[s].Characteristics = IMAGE_SCN_MEM_WRITE | IMAGE_SCN_MEM_READ | IMAGE_SCN_MEM_DISCARDABLE | IMAGE_SCN_CNT_INITIALIZED_DATA;
-
-	IMGHDR(FileHeader.NumberOfSections) = s + 1;
-	// hdr->OptionalHeader.SizeOfImage += salign_len;
-	IMGHDR(OptionalHeader.SizeOfImage) = sec[s].VirtualAddress + salign_len;
-
-	IMGHDR(OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_DEBUG].VirtualAddress) = lastVirtualAddress + datalen;
-	IMGHDR(OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_DEBUG].Size) = sizeof(IMAGE_DEBUG_DIRECTORY);
-
-	// append debug data chunk to existing file image
-	memcpy(newdata, dump_base, dump_total_len);
-	memset(newdata + dump_total_len, 0, fill);
-	memcpy(newdata + dump_total_len + fill, data, datalen);
-
-	if(!dbgDir)
-	{
-		debugdir.Type = 2;
-	}
-	dbgDir = (IMAGE_DEBUG_DIRECTORY*) (newdata + dump_total_len + fill + datalen);
-	memcpy(dbgDir, &debugdir, sizeof(debugdir));
-
-	dbgDir->PointerToRawData = sec[s].PointerToRawData;
-#if 0
-	dbgDir->AddressOfRawData = sec[s].PointerToRawData;
-	dbgDir->SizeOfData = sec[s].SizeOfRawData;
-#else // suggested by Z3N
-	dbgDir->AddressOfRawData = sec[s].VirtualAddress;
-	dbgDir->SizeOfData = sec[s].SizeOfRawData - sizeof(IMAGE_DEBUG_DIRECTORY);
-#endif
-
-	free_aligned(dump_base);
-	dump_base = newdata;
-	dump_total_len += fill + xdatalen;
-
-	return !initCV || initCVPtr(false);
-}
-
-///////////////////////////////////////////////////////////////////////
-bool PEImage::initCVPtr(bool initDbgDir)
-{
-	dos = DPV<IMAGE_DOS_HEADER> (0);
-	if(!dos)
-		return setError("file too small for DOS header");
-	if(dos->e_magic != IMAGE_DOS_SIGNATURE)
-		return setError("this is not a DOS executable");
-
-	hdr32 = DPV<IMAGE_NT_HEADERS32> (dos->e_lfanew);
-	hdr64 = DPV<IMAGE_NT_HEADERS64> (dos->e_lfanew);
-	if(!hdr32)
-		return setError("no optional header found");
-	if(hdr32->FileHeader.Machine == IMAGE_FILE_MACHINE_AMD64 ||
-	   hdr32->FileHeader.Machine == IMAGE_FILE_MACHINE_IA64)
-		hdr32 = 0;
-	else
-		hdr64 = 0;
-
-	if(IMGHDR(Signature) != IMAGE_NT_SIGNATURE)
-		return setError("optional header does not have PE signature");
-	if(IMGHDR(FileHeader.SizeOfOptionalHeader) < sizeof(IMAGE_OPTIONAL_HEADER32))
-		return setError("optional header too small");
-
-	sec = hdr32 ? IMAGE_FIRST_SECTION(hdr32) : IMAGE_FIRST_SECTION(hdr64);
-
-	if(IMGHDR(OptionalHeader.NumberOfRvaAndSizes) <= IMAGE_DIRECTORY_ENTRY_DEBUG)
-		return setError("too few entries in data directory");
-
-	unsigned int i;
-	int found = false;
-	for(i = 0; i < IMGHDR(OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_DEBUG].Size)/sizeof(IMAGE_DEBUG_DIRECTORY); i++)
-	{
-		int off = IMGHDR(OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_DEBUG].VirtualAddress) + i*sizeof(IMAGE_DEBUG_DIRECTORY);
-		dbgDir = RVA<IMAGE_DEBUG_DIRECTORY>(off, sizeof(IMAGE_DEBUG_DIRECTORY));
-		if (!dbgDir) 
-			continue; //return setError("debug directory not placed in image");
-		if (dbgDir->Type != IMAGE_DEBUG_TYPE_CODEVIEW)
-			continue; //return setError("debug directory not of type CodeView");
-
-		cv_base = dbgDir->PointerToRawData;
-		OMFSignature* sig = DPV<OMFSignature>(cv_base, dbgDir->SizeOfData);
-		if (!sig)
-			return setError("invalid debug data base address and size");
-		if (memcmp(sig->Signature, "NB09", 4) != 0 && memcmp(sig->Signature, "NB11", 4) != 0)
-		{
-			// return setError("can only handle debug info of type NB09 and NB11");
-			dirHeader = 0;
-			dirEntry = 0;
-			return true;
-		}
-		dirHeader = CVP<OMFDirHeader>(sig->filepos);
-		if (!dirHeader)
-			return setError("invalid CodeView dir header data base address");
-		dirEntry = CVP<OMFDirEntry>(sig->filepos + dirHeader->cbDirHeader);
-		if (!dirEntry)
-			return setError("CodeView debug dir entries invalid");
-		return true;
-	}
-	return setError("no CodeView debug info data found");
-}
-
-///////////////////////////////////////////////////////////////////////
-bool PEImage::initDWARFPtr(bool initDbgDir)
-{
-	dos = DPV<IMAGE_DOS_HEADER> (0);
-	if(!dos)
-		return setError("file too small for DOS header");
-	if(dos->e_magic != IMAGE_DOS_SIGNATURE)
-		return setError("this is not a DOS executable");
-
-	hdr32 = DPV<IMAGE_NT_HEADERS32> (dos->e_lfanew);
-	hdr64 = DPV<IMAGE_NT_HEADERS64> (dos->e_lfanew);
-	if(!hdr32)
-		return setError("no optional header found");
-	if(hdr32->FileHeader.Machine == IMAGE_FILE_MACHINE_AMD64 ||
-	   hdr32->FileHeader.Machine == IMAGE_FILE_MACHINE_IA64)
-		hdr32 = 0;
-	else
-		hdr64 = 0;
-
-	if(IMGHDR(Signature) != IMAGE_NT_SIGNATURE)
-		return setError("optional header does not have PE signature");
-	if(IMGHDR(FileHeader.SizeOfOptionalHeader) < sizeof(IMAGE_OPTIONAL_HEADER32))
-		return setError("optional header too small");
-
-	dbgDir = 0;
-	sec = hdr32 ? IMAGE_FIRST_SECTION(hdr32) : IMAGE_FIRST_SECTION(hdr64);
-	int nsec = IMGHDR(FileHeader.NumberOfSections);
-	const char* strtable = DPV<char>(IMGHDR(FileHeader.PointerToSymbolTable) + IMGHDR(FileHeader.NumberOfSymbols) * IMAGE_SIZEOF_SYMBOL);
-	for(int s = 0; s < nsec; s++)
-	{
-		const char* name = (const char*) sec[s].Name;
-		if(name[0] == '/')
-		{
-			int off = strtol(name + 1, 0, 10);
-			name = strtable + off;
-		}
-		if(strcmp(name, ".debug_aranges") == 0)
-			debug_aranges = DPV<char>(sec[s].PointerToRawData, sec[s].SizeOfRawData);
-		if(strcmp(name, ".debug_pubnames") == 0)
-			debug_pubnames = DPV<char>(sec[s].PointerToRawData, sec[s].SizeOfRawData);
-		if(strcmp(name, ".debug_pubtypes") == 0)
-			debug_pubtypes = DPV<char>(sec[s].PointerToRawData, sec[s].SizeOfRawData);
-		if(strcmp(name, ".debug_info") == 0)
-			debug_info = DPV<char>(sec[s].PointerToRawData, debug_info_length = sec[s].Misc.VirtualSize);
-		if(strcmp(name, ".debug_abbrev") == 0)
-			debug_abbrev = DPV<char>(sec[s].PointerToRawData, debug_abbrev_length = sec[s].Misc.VirtualSize);
-		if(strcmp(name, ".debug_line") == 0)
-			debug_line = DPV<char>(sec[s].PointerToRawData, debug_line_length = sec[s].Misc.VirtualSize);
-		if(strcmp(name, ".debug_frame") == 0)
-			debug_frame = DPV<char>(sec[s].PointerToRawData, sec[s].SizeOfRawData);
-		if(strcmp(name, ".debug_str") == 0)
-			debug_str = DPV<char>(sec[s].PointerToRawData, sec[s].SizeOfRawData);
-		if(strcmp(name, ".debug_loc") == 0)
-			debug_loc = DPV<char>(sec[s].PointerToRawData, sec[s].SizeOfRawData);
-		if(strcmp(name, ".debug_ranges") == 0)
-			debug_ranges = DPV<char>(sec[s].PointerToRawData, debug_ranges_length = sec[s].Misc.VirtualSize);
-		if(strcmp(name, ".reloc") == 0)
-			reloc = DPV<char>(sec[s].PointerToRawData, reloc_length = sec[s].Misc.VirtualSize);
-		if(strcmp(name, ".text") == 0)
-			codeSegment = s;
-	}
-
-	setError(0);
-
-	return true;
-}
-
-int PEImage::findSection(unsigned int off) const
-{
-	off -= IMGHDR(OptionalHeader.ImageBase);
-	int nsec = IMGHDR(FileHeader.NumberOfSections);
-	for(int s = 0; s < nsec; s++)
-		if(sec[s].VirtualAddress <= off && off < sec[s].VirtualAddress + sec[s].Misc.VirtualSize)
-			return s;
-	return -1;
-}
-
-int PEImage::findSymbol(const char* name, unsigned long& off) const
-{
-	IMAGE_SYMBOL* symtable = DPV<IMAGE_SYMBOL>(IMGHDR(FileHeader.PointerToSymbolTable));
-	int syms = IMGHDR(FileHeader.NumberOfSymbols);
-	const char* strtable = (const char*) (symtable + syms);
-	for(int i = 0; i < syms; i++)
-	{
-		IMAGE_SYMBOL* sym = symtable + i;
-		const char* symname = sym->N.Name.Short == 0 ? strtable + sym->N.Name.Long : (char*)sym->N.ShortName;
-		if(strcmp(symname, name) == 0 || (symname[0] == '_' && strcmp(symname + 1, name) == 0))
-		{
-			off = sym->Value;
-			return sym->SectionNumber;
-		}
-	}
-	return -1;
-}
-
-///////////////////////////////////////////////////////////////////////
-int PEImage::countCVEntries() const
-{
-	return dirHeader ? dirHeader->cDir : 0; 
-}
-
-OMFDirEntry* PEImage::getCVEntry(int i) const
-{
-	return dirEntry + i; 
-}
-
-
-///////////////////////////////////////////////////////////////////////
-// utilities
-void* PEImage::alloc_aligned(unsigned int size, unsigned int align, unsigned int alignoff)
-{
-	if (align & (align - 1))
-		return 0;
-
-	unsigned int pad = align + sizeof(void*);
-	char* p = (char*) malloc(size + pad);
-	unsigned int off = (align + alignoff - sizeof(void*) - (p - (char*) 0)) & (align - 1);
-	char* q = p + sizeof(void*) + off;
-	((void**) q)[-1] = p;
-	return q;
-}
-
-///////////////////////////////////////////////////////////////////////
-void PEImage::free_aligned(void* p)
-{
-	void* q = ((void**) p)[-1];
-	free(q);
-}
+// Convert DMD CodeView debug information to PDB files
+// Copyright (c) 2009-2010 by Rainer Schuetze, All Rights Reserved
+//
+// License for redistribution is given by the Artistic License 2.0
+// see file LICENSE for further details
+
+#ifndef _WIN32
+#define _FILE_OFFSET_BITS 64 // 64-bit st_size on 32-bit systems
+#endif
+
+#include "PEImage.h"
+#include "inflate.h"
+#include "stats.h"
+
+extern "C" {
+#include "mscvpdb.h"
+}
+
+#include <stdio.h>
+#include <stddef.h>
+#include <fcntl.h>
+#include <ctype.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#include <direct.h>
+#include <share.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+// read and write large images in pieces, read() and write() take an unsigned int count
+static const unsigned int kIOChunkSize = 1 << 26;
+
+#if !defined(_WIN32)
+// POSIX file layer: no sharing modes or text mode, 64-bit sizes from stat
+#define T_sopen(name, flags, share)	open(name, flags)
+#define T_open	open
+#define T_fstat	fstat
+#define T_stat	stat
+#define O_BINARY	0
+#elif defined(UNICODE)
+#define T_sopen	_wsopen
+#define T_open	_wopen
+#define T_fstat	_fstat64
+#define T_stat	_stat64
+#else
+#define T_sopen	sopen
+#define T_open	open
+#define T_fstat	_fstat64
+#define T_stat	_stat64
+#endif
+
+///////////////////////////////////////////////////////////////////////
+PEImage::PEImage(const TCHAR* iname)
+: fd(-1)
+, dump_base(0)
+, dump_total_len(0)
+, hdr32(0)
+, hdr64(0)
+, dirHeader(0)
+, lastSectionRange(0)
+, sectionsOverlap(false)
+, symbolIndexBuilt(false)
+, elf(false)
+, elf64(false)
+, elfSectionTable(0)
+, elfSectionSize(0)
+, elfSymbols(0)
+, elfSymbolCount(0)
+, elfSymbolNames(0)
+, elfSymbolNamesLength(0)
+, debug_aranges(0)
+, debug_aranges_length(0)
+, debug_pubnames(0)
+, debug_pubnames_length(0)
+, debug_pubtypes(0)
+, debug_pubtypes_length(0)
+, debug_info(0)
+, debug_abbrev(0)
+, debug_line(0)
+, debug_frame(0)
+, debug_str(0)
+, debug_str_length(0)
+, debug_loc(0)
+, debug_loc_length(0)
+, debug_ranges(0)
+, debug_line_str(0)
+, debug_line_str_length(0)
+, debug_str_offsets(0)
+, debug_str_offsets_length(0)
+, debug_addr(0)
+, debug_addr_length(0)
+, debug_rnglists(0)
+, debug_rnglists_length(0)
+, reloc(0)
+, reloc_length(0)
+, codeSegment(0)
+{
+	if(iname)
+		load(iname);
+}
+
+PEImage::~PEImage()
+{
+	if(fd != -1)
+		close(fd);
+	if(dump_base)
+		free_aligned(dump_base);
+	for(size_t i = 0; i < decompressed.size(); i++)
+		free(decompressed[i]);
+}
+
+///////////////////////////////////////////////////////////////////////
+bool PEImage::load(const TCHAR* iname)
+{
+	if (fd != -1)
+		return setError("file already open");
+
+	fd = T_sopen(iname, O_RDONLY | O_BINARY, SH_DENYWR);
+	if (fd == -1) 
+		return setError("Can't open file");
+
+	struct T_stat s;
+	if (T_fstat(fd, &s) < 0)
+		return setError("Can't get size");
+	dump_total_len = s.st_size;
+	if (dump_total_len > 0xffffffffULL)
+		return setError("file too large for a PE image");
+
+	dump_base = alloc_aligned(dump_total_len, 0x1000);
+	if (!dump_base)
+		return setError("Out of memory");
+	for (unsigned long long pos = 0; pos < dump_total_len; )
+	{
+		unsigned int chunk = (unsigned int) std::min<unsigned long long>(dump_total_len - pos, kIOChunkSize);
+		if (read(fd, (char*) dump_base + pos, chunk) != (int) chunk)
+			return setError("Cannot read file");
+		pos += chunk;
+	}
+
+	close(fd);
+	fd = -1;
+	return initPtr();
+}
+
+///////////////////////////////////////////////////////////////////////
+bool PEImage::loadMemory(const void* data, unsigned long long size)
+{
+	if (dump_base)
+		return setError("image already loaded");
+	if (size > 0xffffffffULL)
+		return setError("file too large for a PE image");
+
+	// the image is modified and reallocated by replaceDebugSection, so work on a copy
+	dump_total_len = size;
+	dump_base = alloc_aligned(dump_total_len, 0x1000);
+	if (!dump_base)
+		return setError("Out of memory");
+	memcpy(dump_base, data, dump_total_len);
+	return initPtr();
+}
+
+bool PEImage::initPtr()
+{
+	if (dump_total_len >= 4 && memcmp(dump_base, "\x7f" "ELF", 4) == 0)
+		return initELFPtr();
+	// an RSDS record left by a linker or a previous conversion is no CodeView debug information
+	if (initCVPtr(true) && dirHeader)
+		return true;
+	return initDWARFPtr(true);
+}
+
+///////////////////////////////////////////////////////////////////////
+bool PEImage::save(const TCHAR* oname)
+{
+	if (fd != -1)
+		return setError("file already open");
+
+	if (!dump_base)
+		return setError("no data to dump");
+
+	fd = T_open(oname, O_WRONLY | O_CREAT | O_BINARY | O_TRUNC, S_IREAD | S_IWRITE | S_IEXEC);
+	if (fd == -1) 
+		return setError("Can't create file");
+
+	for (unsigned long long pos = 0; pos < dump_total_len; )
+	{
+		unsigned int chunk = (unsigned int) std::min<unsigned long long>(dump_total_len - pos, kIOChunkSize);
+		if (write(fd, (char*) dump_base + pos, chunk) != (int) chunk)
+			return setError("Cannot write file");
+		pos += chunk;
+	}
+
+	close(fd);
+	fd = -1;
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////
+bool PEImage::replaceDebugSection (const void* data, unsigned long datalen, bool initCV)
+{
+	if(elf)
+		return setError("cannot add debug directory to ELF file");
+
+	// append new debug directory to data
+	IMAGE_DEBUG_DIRECTORY debugdir;
+	if(dbgDir)
+		debugdir = *dbgDir;
+	else
+		memset(&debugdir, 0, sizeof(debugdir));
+	unsigned long long xdatalen = datalen + sizeof(debugdir);
+
+	// assume there is place for another section because of section alignment
+	int s;
+	DWORD lastVirtualAddress = 0;
+	int cntSections = countSections();
+	for(s = 0; s < cntSections; s++)
+	{
+		if (strcmp ((char*) sec [s].Name, ".debug") == 0)
+		{
+			if (s == cntSections - 1)
+			{
+				dump_total_len = sec[s].PointerToRawData;
+				break;
+			}
+			strcpy ((char*) sec [s].Name, ".ddebug");
+			printf("warning: .debug not last section, cannot remove section\n");
+		}
+		lastVirtualAddress = sec [s].VirtualAddress + sec[s].Misc.VirtualSize;
+	}
+
+	unsigned int align = IMGHDR(OptionalHeader.FileAlignment);
+	unsigned long long align_len = xdatalen;
+	unsigned int fill = 0;
+
+	if (align > 0)
+	{
+		fill = (unsigned int) ((align - (dump_total_len % align)) % align);
+		align_len = ((xdatalen + align - 1) / align) * align;
+	}
+	// section offsets and sizes are 32-bit
+	if (dump_total_len + fill + align_len > 0xffffffffULL)
+		return setError("image too large to add debug section");
+	char* newdata = (char*) alloc_aligned(dump_total_len + fill + xdatalen, 0x1000);
+	if(!newdata)
+		return setError("cannot alloc new image");
+
+	unsigned long long salign_len = xdatalen;
+	align = IMGHDR(OptionalHeader.SectionAlignment);
+	if (align > 0)
+	{
+		lastVirtualAddress = ((lastVirtualAddress + align - 1) / align) * align;
+		salign_len = ((xdatalen + align - 1) / align) * align;
+	}
+
+	strcpy((char*) sec[s].Name, ".debug");
+	sec[s].Misc.VirtualSize = (DWORD) align_len; // union with PhysicalAddress;
+	sec[s].VirtualAddress = lastVirtualAddress;
+	sec[s].SizeOfRawData = (DWORD) xdatalen;
+	sec[s].PointerToRawData = (DWORD) (dump_total_len + fill);
+	sec[s].PointerToRelocations = 0;
+	sec[s].PointerToLinenumbers = 0;
+	sec[s].NumberOfRelocations = 0;
+	sec[s].NumberOfLinenumbers = 0;
+	sec[s].Characteristics = IMAGE_SCN_MEM_WRITE | IMAGE_SCN_MEM_READ | IMAGE_SCN_MEM_DISCARDABLE | IMAGE_SCN_CNT_INITIALIZED_DATA;
+
+	IMGHDR(FileHeader.NumberOfSections) = s + 1;
+	// hdr->OptionalHeader.SizeOfImage += salign_len;
+	IMGHDR(OptionalHeader.SizeOfImage) = (DWORD) (sec[s].VirtualAddress + salign_len);
+
+	IMGHDR(OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_DEBUG].VirtualAddress) = lastVirtualAddress + datalen;
+	IMGHDR(OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_DEBUG].Size) = sizeof(IMAGE_DEBUG_DIRECTORY);
+
+	// append debug data chunk to existing file image
+	memcpy(newdata, dump_base, dump_total_len);
+	memset(newdata + dump_total_len, 0, fill);
+	memcpy(newdata + dump_total_len + fill, data, datalen);
+
+	if(!dbgDir)
+	{
+		debugdir.Type = 2;
+	}
+	dbgDir = (IMAGE_DEBUG_DIRECTORY*) (newdata + dump_total_len + fill + datalen);
+	memcpy(dbgDir, &debugdir, sizeof(debugdir));
+
+	dbgDir->PointerToRawData = sec[s].PointerToRawData;
+#if 0
+	dbgDir->AddressOfRawData = sec[s].PointerToRawData;
+	dbgDir->SizeOfData = sec[s].SizeOfRawData;
+#else // suggested by Z3N
+	dbgDir->AddressOfRawData = sec[s].VirtualAddress;
+	dbgDir->SizeOfData = sec[s].SizeOfRawData - sizeof(IMAGE_DEBUG_DIRECTORY);
+#endif
+
+	// headers and symbol names pointed into the old image
+	char* oldbase = (char*) dump_base;
+	dos = (IMAGE_DOS_HEADER*) (newdata + ((char*) dos - oldbase));
+	if(hdr32)
+		hdr32 = (IMAGE_NT_HEADERS32*) (newdata + ((char*) hdr32 - oldbase));
+	if(hdr64)
+		hdr64 = (IMAGE_NT_HEADERS64*) (newdata + ((char*) hdr64 - oldbase));
+	sec = (IMAGE_SECTION_HEADER*) (newdata + ((char*) sec - oldbase));
+	symbolIndex.clear();
+	symbolIndexBuilt = false;
+
+	free_aligned(dump_base);
+	dump_base = newdata;
+	dump_total_len += fill + xdatalen;
+	initSectionRanges();
+
+	return !initCV || initCVPtr(false);
+}
+
+///////////////////////////////////////////////////////////////////////
+bool PEImage::initCVPtr(bool initDbgDir)
+{
+	dos = DPV<IMAGE_DOS_HEADER> (0);
+	if(!dos)
+		return setError("file too small for DOS header");
+	if(dos->e_magic != IMAGE_DOS_SIGNATURE)
+		return setError("this is not a DOS executable");
+
+	hdr32 = DPV<IMAGE_NT_HEADERS32> (dos->e_lfanew);
+	hdr64 = DPV<IMAGE_NT_HEADERS64> (dos->e_lfanew);
+	if(!hdr32)
+		return setError("no optional header found");
+	if(hdr32->FileHeader.Machine == IMAGE_FILE_MACHINE_AMD64 ||
+	   hdr32->FileHeader.Machine == IMAGE_FILE_MACHINE_IA64)
+		hdr32 = 0;
+	else
+		hdr64 = 0;
+
+	if(IMGHDR(Signature) != IMAGE_NT_SIGNATURE)
+		return setError("optional header does not have PE signature");
+	if(IMGHDR(FileHeader.SizeOfOptionalHeader) < sizeof(IMAGE_OPTIONAL_HEADER32))
+		return setError("optional header too small");
+
+	sec = hdr32 ? IMAGE_FIRST_SECTION(hdr32) : IMAGE_FIRST_SECTION(hdr64);
+	initSectionRanges();
+
+	if(IMGHDR(OptionalHeader.NumberOfRvaAndSizes) <= IMAGE_DIRECTORY_ENTRY_DEBUG)
+		return setError("too few entries in data directory");
+
+	unsigned int i;
+	for(i = 0; i < IMGHDR(OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_DEBUG].Size)/sizeof(IMAGE_DEBUG_DIRECTORY); i++)
+	{
+		int off = IMGHDR(OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_DEBUG].VirtualAddress) + i*sizeof(IMAGE_DEBUG_DIRECTORY);
+		dbgDir = RVA<IMAGE_DEBUG_DIRECTORY>(off, sizeof(IMAGE_DEBUG_DIRECTORY));
+		if (!dbgDir) 
+			continue; //return setError("debug directory not placed in image");
+		if (dbgDir->Type != IMAGE_DEBUG_TYPE_CODEVIEW)
+			continue; //return setError("debug directory not of type CodeView");
+
+		cv_base = dbgDir->PointerToRawData;
+		OMFSignature* sig = DPV<OMFSignature>(cv_base, dbgDir->SizeOfData);
+		if (!sig)
+			return setError("invalid debug data base address and size");
+		if (memcmp(sig->Signature, "NB09", 4) != 0 && memcmp(sig->Signature, "NB11", 4) != 0)
+		{
+			// return setError("can only handle debug info of type NB09 and NB11");
+			dirHeader = 0;
+			dirEntry = 0;
+			return true;
+		}
+		dirHeader = CVP<OMFDirHeader>(sig->filepos);
+		if (!dirHeader)
+			return setError("invalid CodeView dir header data base address");
+		dirEntry = CVP<OMFDirEntry>(sig->filepos + dirHeader->cbDirHeader);
+		if (!dirEntry)
+			return setError("CodeView debug dir entries invalid");
+		return true;
+	}
+	return setError("no CodeView debug info data found");
+}
+
+///////////////////////////////////////////////////////////////////////
+bool PEImage::initDWARFPtr(bool initDbgDir)
+{
+	dos = DPV<IMAGE_DOS_HEADER> (0);
+	if(!dos)
+		return setError("file too small for DOS header");
+	if(dos->e_magic != IMAGE_DOS_SIGNATURE)
+		return setError("this is not a DOS executable");
+
+	hdr32 = DPV<IMAGE_NT_HEADERS32> (dos->e_lfanew);
+	hdr64 = DPV<IMAGE_NT_HEADERS64> (dos->e_lfanew);
+	if(!hdr32)
+		return setError("no optional header found");
+	if(hdr32->FileHeader.Machine == IMAGE_FILE_MACHINE_AMD64 ||
+	   hdr32->FileHeader.Machine == IMAGE_FILE_MACHINE_IA64)
+		hdr32 = 0;
+	else
+		hdr64 = 0;
+
+	if(IMGHDR(Signature) != IMAGE_NT_SIGNATURE)
+		return setError("optional header does not have PE signature");
+	if(IMGHDR(FileHeader.SizeOfOptionalHeader) < sizeof(IMAGE_OPTIONAL_HEADER32))
+		return setError("optional header too small");
+
+	dbgDir = 0;
+	sec = hdr32 ? IMAGE_FIRST_SECTION(hdr32) : IMAGE_FIRST_SECTION(hdr64);
+	initSectionRanges();
+	int nsec = IMGHDR(FileHeader.NumberOfSections);
+	const char* strtable = DPV<char>(IMGHDR(FileHeader.PointerToSymbolTable) + IMGHDR(FileHeader.NumberOfSymbols) * IMAGE_SIZEOF_SYMBOL);
+	for(int s = 0; s < nsec; s++)
+	{
+		const char* name = (const char*) sec[s].Name;
+		if(name[0] == '/')
+		{
+			int off = strtol(name + 1, 0, 10);
+			name = strtable + off;
+		}
+		if(strcmp(name, ".debug_aranges") == 0)
+			debug_aranges = DPV<char>(sec[s].PointerToRawData, debug_aranges_length = sec[s].Misc.VirtualSize);
+		if(strcmp(name, ".debug_pubnames") == 0)
+			debug_pubnames = DPV<char>(sec[s].PointerToRawData, debug_pubnames_length = sec[s].Misc.VirtualSize);
+		if(strcmp(name, ".debug_pubtypes") == 0)
+			debug_pubtypes = DPV<char>(sec[s].PointerToRawData, debug_pubtypes_length = sec[s].Misc.VirtualSize);
+		if(strcmp(name, ".debug_info") == 0)
+			debug_info = DPV<char>(sec[s].PointerToRawData, debug_info_length = sec[s].Misc.VirtualSize);
+		if(strcmp(name, ".debug_abbrev") == 0)
+			debug_abbrev = DPV<char>(sec[s].PointerToRawData, debug_abbrev_length = sec[s].Misc.VirtualSize);
+		if(strcmp(name, ".debug_line") == 0)
+			debug_line = DPV<char>(sec[s].PointerToRawData, debug_line_length = sec[s].Misc.VirtualSize);
+		if(strcmp(name, ".debug_frame") == 0)
+			debug_frame = DPV<char>(sec[s].PointerToRawData, sec[s].SizeOfRawData);
+		if(strcmp(name, ".debug_str") == 0)
+			debug_str = DPV<char>(sec[s].PointerToRawData, debug_str_length = sec[s].SizeOfRawData);
+		if(strcmp(name, ".debug_loc") == 0)
+			debug_loc = DPV<char>(sec[s].PointerToRawData, debug_loc_length = sec[s].SizeOfRawData);
+		if(strcmp(name, ".debug_ranges") == 0)
+			debug_ranges = DPV<char>(sec[s].PointerToRawData, debug_ranges_length = sec[s].Misc.VirtualSize);
+		if(strcmp(name, ".debug_line_str") == 0)
+			debug_line_str = DPV<char>(sec[s].PointerToRawData, debug_line_str_length = sec[s].Misc.VirtualSize);
+		if(strcmp(name, ".debug_str_offsets") == 0)
+			debug_str_offsets = DPV<char>(sec[s].PointerToRawData, debug_str_offsets_length = sec[s].Misc.VirtualSize);
+		if(strcmp(name, ".debug_addr") == 0)
+			debug_addr = DPV<char>(sec[s].PointerToRawData, debug_addr_length = sec[s].Misc.VirtualSize);
+		if(strcmp(name, ".debug_rnglists") == 0)
+			debug_rnglists = DPV<char>(sec[s].PointerToRawData, debug_rnglists_length = sec[s].Misc.VirtualSize);
+		if(strcmp(name, ".reloc") == 0)
+			reloc = DPV<char>(sec[s].PointerToRawData, reloc_length = sec[s].Misc.VirtualSize);
+		if(strcmp(name, ".text") == 0)
+			codeSegment = s;
+		if(strncmp(name, ".zdebug_", 8) == 0)
+			if(!addGNUCompressedSection(name + 8, DPV<char>(sec[s].PointerToRawData, sec[s].Misc.VirtualSize), sec[s].Misc.VirtualSize))
+				return false;
+	}
+
+	if(!compressedSections.empty())
+		if(!STAT_PHASE("decompressSections", decompressSections()))
+			return false;
+
+	setError(0);
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////
+bool PEImage::findRSDS(GUID& guid, unsigned long& age)
+{
+	if(elf || IMGHDR(OptionalHeader.NumberOfRvaAndSizes) <= IMAGE_DIRECTORY_ENTRY_DEBUG)
+		return false;
+
+	unsigned int cnt = IMGHDR(OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_DEBUG].Size)/sizeof(IMAGE_DEBUG_DIRECTORY);
+	for(unsigned int i = 0; i < cnt; i++)
+	{
+		int off = IMGHDR(OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_DEBUG].VirtualAddress) + i*sizeof(IMAGE_DEBUG_DIRECTORY);
+		IMAGE_DEBUG_DIRECTORY* dir = RVA<IMAGE_DEBUG_DIRECTORY>(off, sizeof(IMAGE_DEBUG_DIRECTORY));
+		if (!dir || dir->Type != IMAGE_DEBUG_TYPE_CODEVIEW)
+			continue;
+		OMFSignatureRSDS* rsds = DPV<OMFSignatureRSDS>(dir->PointerToRawData, dir->SizeOfData);
+		if (!rsds || dir->SizeOfData <= offsetof(OMFSignatureRSDS, name) || memcmp(rsds->Signature, "RSDS", 4) != 0)
+			continue;
+		guid = rsds->guid;
+		age = rsds->age;
+		return true;
+	}
+	return false;
+}
+
+///////////////////////////////////////////////////////////////////////
+// ELF executables and shared objects: the DWARF sections are taken from the
+// section table, PE headers are synthesized for the allocated sections so that
+// addresses translate to section and offset as for a PE image.
+
+// little endian field of size bytes at p
+static unsigned long long elfField(const char* p, int size)
+{
+	unsigned long long v = 0;
+	for(int i = size - 1; i >= 0; i--)
+		v = (v << 8) | (unsigned char) p[i];
+	return v;
+}
+
+struct ELFSection
+{
+	unsigned int name;
+	unsigned int type;
+	unsigned long long flags;
+	unsigned long long addr;
+	unsigned long long offset;
+	unsigned long long size;
+	unsigned int link;
+};
+
+static const int SHT_SYMTAB = 2;
+static const int SHT_NOBITS = 8;
+static const int SHT_DYNSYM = 11;
+static const int SHF_WRITE = 0x1;
+static const int SHF_ALLOC = 0x2;
+static const int SHF_EXECINSTR = 0x4;
+static const int SHF_TLS = 0x400;
+static const int SHF_COMPRESSED = 0x800;
+static const int ELFCOMPRESS_ZLIB = 1;
+static const int SHN_LORESERVE = 0xff00;
+static const int SHN_XINDEX = 0xffff;
+
+// allocated sections mapped to PE sections. .tbss only describes the
+// initial thread local data, its addresses overlap the following sections.
+static bool isImageSection(const ELFSection& es)
+{
+	if(!(es.flags & SHF_ALLOC) || es.size == 0)
+		return false;
+	return !((es.flags & SHF_TLS) && es.type == SHT_NOBITS);
+}
+
+bool PEImage::readELFSection(int idx, ELFSection& es) const
+{
+	unsigned long long off = elfSectionTable + (unsigned long long) idx * elfSectionSize;
+	const char* p = DPV<char>(off, elf64 ? 64 : 40);
+	if(!p)
+		return false;
+	es.name  = (unsigned int) elfField(p, 4);
+	es.type  = (unsigned int) elfField(p + 4, 4);
+	if(elf64)
+	{
+		es.flags  = elfField(p + 8, 8);
+		es.addr   = elfField(p + 16, 8);
+		es.offset = elfField(p + 24, 8);
+		es.size   = elfField(p + 32, 8);
+		es.link   = (unsigned int) elfField(p + 40, 4);
+	}
+	else
+	{
+		es.flags  = elfField(p + 8, 4);
+		es.addr   = elfField(p + 12, 4);
+		es.offset = elfField(p + 16, 4);
+		es.size   = elfField(p + 20, 4);
+		es.link   = (unsigned int) elfField(p + 24, 4);
+	}
+	return true;
+}
+
+bool PEImage::initELFPtr()
+{
+	const char* ehdr = DPV<char>(0, 52);
+	if(!ehdr)
+		return setError("file too small for ELF header");
+	if(ehdr[4] != 1 && ehdr[4] != 2)
+		return setError("unknown ELF class");
+	if(ehdr[5] != 1)
+		return setError("only little endian ELF files are supported");
+	elf64 = ehdr[4] == 2;
+	if(elf64 && !DPV<char>(0, 64))
+		return setError("file too small for ELF header");
+
+	int type = (int) elfField(ehdr + 16, 2);
+	if(type == 1)
+		return setError("relocatable ELF object files are not supported");
+	int machine = (int) elfField(ehdr + 18, 2);
+
+	int shnum, shstrndx;
+	if(elf64)
+	{
+		elfSectionTable = elfField(ehdr + 40, 8);
+		elfSectionSize  = (int) elfField(ehdr + 58, 2);
+		shnum           = (int) elfField(ehdr + 60, 2);
+		shstrndx        = (int) elfField(ehdr + 62, 2);
+	}
+	else
+	{
+		elfSectionTable = elfField(ehdr + 32, 4);
+		elfSectionSize  = (int) elfField(ehdr + 46, 2);
+		shnum           = (int) elfField(ehdr + 48, 2);
+		shstrndx        = (int) elfField(ehdr + 50, 2);
+	}
+	if(elfSectionSize < (elf64 ? 64 : 40))
+		return setError("invalid ELF section header size");
+
+	// extended section numbering stores the counts in the first section header
+	ELFSection first;
+	if(elfSectionTable == 0 || !readELFSection(0, first))
+		return setError("no ELF section table found");
+	if(shnum == 0)
+		shnum = (int) first.size;
+	if(shstrndx == SHN_XINDEX)
+		shstrndx = first.link;
+
+	ELFSection shstr;
+	if(shstrndx >= shnum || !readELFSection(shstrndx, shstr))
+		return setError("no ELF section name table found");
+	const char* names = DPV<char>(shstr.offset, shstr.size);
+	if(!names)
+		return setError("invalid ELF section name table");
+
+	std::vector<ELFSection> sections(shnum);
+	for(int i = 0; i < shnum; i++)
+		if(!readELFSection(i, sections[i]))
+			return setError("invalid ELF section table");
+
+	// PE headers for the allocated sections, the image base is the lowest address
+	int nalloc = 0;
+	unsigned long long base = ~0ULL;
+	for(int i = 1; i < shnum; i++)
+		if(isImageSection(sections[i]))
+		{
+			nalloc++;
+			base = std::min(base, sections[i].addr & ~0xfffULL);
+		}
+	if(nalloc == 0)
+		base = 0;
+
+	size_t ntsize = elf64 ? sizeof(IMAGE_NT_HEADERS64) : sizeof(IMAGE_NT_HEADERS32);
+	elfHeaders.assign(ntsize + nalloc * sizeof(IMAGE_SECTION_HEADER), 0);
+	dos = 0;
+	dbgDir = 0;
+	hdr32 = elf64 ? 0 : (IMAGE_NT_HEADERS32*) &elfHeaders[0];
+	hdr64 = elf64 ? (IMAGE_NT_HEADERS64*) &elfHeaders[0] : 0;
+	IMGHDR(Signature) = IMAGE_NT_SIGNATURE;
+	IMGHDR(FileHeader.Machine) = machine == 62 ? IMAGE_FILE_MACHINE_AMD64 : IMAGE_FILE_MACHINE_I386; // EM_X86_64
+	IMGHDR(FileHeader.NumberOfSections) = nalloc;
+	IMGHDR(FileHeader.SizeOfOptionalHeader) = elf64 ? sizeof(IMAGE_OPTIONAL_HEADER64) : sizeof(IMAGE_OPTIONAL_HEADER32);
+	IMGHDR(OptionalHeader.Magic) = elf64 ? IMAGE_NT_OPTIONAL_HDR64_MAGIC : IMAGE_NT_OPTIONAL_HDR32_MAGIC;
+	if(elf64)
+		hdr64->OptionalHeader.ImageBase = base;
+	else
+		hdr32->OptionalHeader.ImageBase = (DWORD) base;
+	sec = hdr32 ? IMAGE_FIRST_SECTION(hdr32) : IMAGE_FIRST_SECTION(hdr64);
+
+	elfSectionMap.assign(shnum, -1);
+	int symtab = -1;
+	int s = 0;
+	for(int i = 1; i < shnum; i++)
+	{
+		const ELFSection& es = sections[i];
+		const char* name = es.name < shstr.size ? names + es.name : "";
+		if(isImageSection(es))
+		{
+			if(es.addr - base > 0xffffffffULL || es.size > 0xffffffffULL)
+				return setError("ELF section address out of range");
+			strncpy((char*) sec[s].Name, name, IMAGE_SIZEOF_SHORT_NAME);
+			sec[s].Misc.VirtualSize = (DWORD) es.size;
+			sec[s].VirtualAddress = (DWORD) (es.addr - base);
+			sec[s].SizeOfRawData = es.type == SHT_NOBITS ? 0 : (DWORD) es.size;
+			sec[s].PointerToRawData = es.type == SHT_NOBITS ? 0 : (DWORD) es.offset;
+			sec[s].Characteristics = IMAGE_SCN_MEM_READ;
+			if(es.flags & SHF_EXECINSTR)
+				sec[s].Characteristics |= IMAGE_SCN_CNT_CODE | IMAGE_SCN_MEM_EXECUTE;
+			else if(es.type == SHT_NOBITS)
+				sec[s].Characteristics |= IMAGE_SCN_CNT_UNINITIALIZED_DATA;
+			else
+				sec[s].Characteristics |= IMAGE_SCN_CNT_INITIALIZED_DATA;
+			if(es.flags & SHF_WRITE)
+				sec[s].Characteristics |= IMAGE_SCN_MEM_WRITE;
+			if(strcmp(name, ".text") == 0)
+				codeSegment = s;
+			elfSectionMap[i] = s++;
+		}
+
+		if(es.type == SHT_SYMTAB || (es.type == SHT_DYNSYM && symtab < 0))
+			symtab = i;
+
+		char** ptr;
+		unsigned long* length;
+		const char* data = DPV<char>(es.offset, es.size);
+		if(strncmp(name, ".debug_", 7) == 0 && findDWARFSection(name + 7, ptr, length))
+		{
+			if(!data)
+				return setError("invalid ELF debug section");
+			if(es.flags & SHF_COMPRESSED)
+			{
+				// Elf32_Chdr/Elf64_Chdr: type, size, alignment
+				int chdrsize = elf64 ? 24 : 12;
+				if(es.size < (unsigned) chdrsize || elfField(data, 4) != ELFCOMPRESS_ZLIB)
+					return setError("unsupported compressed debug section");
+				unsigned long long size = elf64 ? elfField(data + 8, 8) : elfField(data + 4, 4);
+				if(!addCompressedSection(name + 7, (const unsigned char*) data + chdrsize, (unsigned long) (es.size - chdrsize), size))
+					return false;
+			}
+			else
+			{
+				if(es.size > 0xffffffffULL)
+					return setError("ELF debug section too large");
+				*ptr = (char*) data;
+				*length = (unsigned long) es.size;
+			}
+		}
+		if(strncmp(name, ".zdebug_", 8) == 0)
+			if(!addGNUCompressedSection(name + 8, data, data ? (unsigned long) es.size : 0))
+				return false;
+	}
+	initSectionRanges();
+
+	if(symtab >= 0)
+	{
+		const ELFSection& ss = sections[symtab];
+		int entsize = elf64 ? 24 : 16;
+		elfSymbols = DPV<char>(ss.offset, ss.size);
+		elfSymbolCount = elfSymbols ? (unsigned long) (ss.size / entsize) : 0;
+		if(ss.link < (unsigned int) shnum)
+			elfSymbolNames = DPV<char>(sections[ss.link].offset, elfSymbolNamesLength = sections[ss.link].size);
+		if(!elfSymbolNames)
+			elfSymbolCount = 0;
+	}
+
+	if(!compressedSections.empty())
+		if(!STAT_PHASE("decompressSections", decompressSections()))
+			return false;
+
+	elf = true;
+	setError(0);
+	return true;
+}
+
+void PEImage::buildELFSymbolIndex() const
+{
+	int entsize = elf64 ? 24 : 16;
+	symbolIndex.reserve(elfSymbolCount);
+	for(unsigned long i = 1; i < elfSymbolCount; i++)
+	{
+		const char* sym = elfSymbols + i * entsize;
+		unsigned long long nameoff = elfField(sym, 4);
+		unsigned long long value = elf64 ? elfField(sym + 8, 8) : elfField(sym + 4, 4);
+		int shndx = (int) (elf64 ? elfField(sym + 6, 2) : elfField(sym + 14, 2));
+		if(shndx == 0 || shndx >= SHN_LORESERVE || shndx >= (int) elfSectionMap.size() || elfSectionMap[shndx] < 0)
+			continue; // undefined, absolute, common or not allocated
+		if(nameoff >= elfSymbolNamesLength)
+			continue;
+
+		int s = elfSectionMap[shndx];
+		SymbolName name;
+		name.ptr = elfSymbolNames + nameoff;
+		name.len = strnlen(name.ptr, (size_t) (elfSymbolNamesLength - nameoff));
+		SymbolLocation loc = { s, (unsigned long) (value - getImageBase() - sec[s].VirtualAddress) };
+		symbolIndex.insert(std::make_pair(name, loc));
+	}
+}
+
+///////////////////////////////////////////////////////////////////////
+// DWARF sections read by the conversion, name without ".debug_"
+bool PEImage::findDWARFSection(const char* name, char**& ptr, unsigned long*& length)
+{
+	struct { const char* name; char** ptr; unsigned long* length; } needed[] =
+	{
+		{ "aranges",  &debug_aranges,  &debug_aranges_length },
+		{ "pubnames", &debug_pubnames, &debug_pubnames_length },
+		{ "pubtypes", &debug_pubtypes, &debug_pubtypes_length },
+		{ "info",     &debug_info,     &debug_info_length },
+		{ "abbrev",   &debug_abbrev,   &debug_abbrev_length },
+		{ "line",     &debug_line,     &debug_line_length },
+		{ "str",      &debug_str,      &debug_str_length },
+		{ "loc",      &debug_loc,      &debug_loc_length },
+		{ "ranges",   &debug_ranges,   &debug_ranges_length },
+		{ "line_str", &debug_line_str, &debug_line_str_length },
+		{ "str_offsets", &debug_str_offsets, &debug_str_offsets_length },
+		{ "addr",     &debug_addr,     &debug_addr_length },
+		{ "rnglists", &debug_rnglists, &debug_rnglists_length },
+	};
+	for(size_t n = 0; n < sizeof(needed) / sizeof(needed[0]); n++)
+		if(strcmp(name, needed[n].name) == 0)
+		{
+			ptr = needed[n].ptr;
+			length = needed[n].length;
+			return true;
+		}
+	return false;
+}
+
+bool PEImage::addCompressedSection(const char* name, const unsigned char* zdata, unsigned long zlength, unsigned long long size)
+{
+	// only sections read by the conversion, e.g. .zdebug_frame is ignored
+	CompressedSection zs;
+	if(!findDWARFSection(name, zs.ptr, zs.ptr_length))
+		return true;
+	if(size > 0xffffffffUL)
+		return setError("compressed debug section too large");
+	zs.data = zdata;
+	zs.length = zlength;
+	zs.size = size;
+	compressedSections.push_back(zs);
+	return true;
+}
+
+// GNU style compressed section: "ZLIB", 8 byte big endian uncompressed size, zlib stream
+bool PEImage::addGNUCompressedSection(const char* name, const char* data, unsigned long length)
+{
+	const unsigned char* p = (const unsigned char*) data;
+	if(!p || length < 12 || memcmp(p, "ZLIB", 4) != 0)
+		return setError("unsupported compressed debug section");
+
+	unsigned long long size = 0;
+	for(int i = 4; i < 12; i++)
+		size = (size << 8) | p[i];
+	return addCompressedSection(name, p + 12, length - 12, size);
+}
+
+// a zlib stream can only be inflated sequentially, so sections are distributed
+// to threads, largest first, each decompressing into a buffer allocated up front
+bool PEImage::decompressSections()
+{
+	std::vector<CompressedSection*> work;
+	unsigned long long total = 0;
+	for(size_t i = 0; i < compressedSections.size(); i++)
+	{
+		CompressedSection& zs = compressedSections[i];
+		char* buf = (char*) malloc(zs.size ? (size_t) zs.size : 1);
+		if(!buf)
+			return setError("cannot alloc decompressed debug section");
+		decompressed.push_back(buf);
+		*zs.ptr = buf;
+		*zs.ptr_length = (unsigned long) zs.size;
+		work.push_back(&zs);
+		total += zs.size;
+	}
+	std::sort(work.begin(), work.end(),
+	          [](const CompressedSection* a, const CompressedSection* b) { return a->length > b->length; });
+
+	std::vector<char> ok(work.size(), 0);
+	std::atomic<size_t> next(0);
+	auto worker = [&]()
+	{
+		for(size_t i; (i = next++) < work.size(); )
+			ok[i] = inflateZlib(work[i]->data, work[i]->length,
+			                    (unsigned char*) *work[i]->ptr, (unsigned long) work[i]->size);
+	};
+
+	size_t nthreads = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), work.size());
+	std::vector<std::thread> threads;
+	for(size_t t = 1; t < nthreads; t++)
+		threads.push_back(std::thread(worker));
+	worker();
+	for(size_t t = 0; t < threads.size(); t++)
+		threads[t].join();
+
+	compressedSections.clear();
+	for(size_t i = 0; i < ok.size(); i++)
+		if(!ok[i])
+			return setError("cannot decompress debug section");
+
+	countStat(kStatBytesDecompressed, total);
+	return true;
+}
+
+void PEImage::initSectionRanges()
+{
+	sectionRanges.clear();
+	lastSectionRange = 0;
+	sectionsOverlap = false;
+	int nsec = IMGHDR(FileHeader.NumberOfSections);
+	for(int s = 0; s < nsec; s++)
+	{
+		SectionRange r;
+		r.start = sec[s].VirtualAddress;
+		r.virtEnd = sec[s].VirtualAddress + sec[s].Misc.VirtualSize;
+		r.rawEnd = sec[s].VirtualAddress + sec[s].SizeOfRawData;
+		r.sec = s;
+		sectionRanges.push_back(r);
+	}
+	// stable to keep the first of sections with the same address, as the linear search did
+	std::stable_sort(sectionRanges.begin(), sectionRanges.end(),
+	                 [](const SectionRange& a, const SectionRange& b) { return a.start < b.start; });
+
+	unsigned long maxEnd = 0;
+	for(size_t i = 0; i < sectionRanges.size(); i++)
+	{
+		const SectionRange& r = sectionRanges[i];
+		if(i > 0 && r.start < maxEnd)
+			sectionsOverlap = true;
+		maxEnd = std::max(maxEnd, std::max(r.virtEnd, r.rawEnd));
+	}
+}
+
+int PEImage::findSectionRange(unsigned long rva, unsigned long len, bool raw) const
+{
+	unsigned long long end = (unsigned long long) rva + len;
+	if(sectionsOverlap)
+	{
+		// the first section in header order containing the range, which the
+		// cache and the binary search cannot tell if several contain it
+		int nsec = IMGHDR(FileHeader.NumberOfSections);
+		for(int s = 0; s < nsec; s++)
+			if(sec[s].VirtualAddress <= rva && end <= (unsigned long long) sec[s].VirtualAddress + (raw ? sec[s].SizeOfRawData : sec[s].Misc.VirtualSize))
+				return s;
+		return -1;
+	}
+
+	// the line numbers are decoded in another thread, so the cache is atomic
+	size_t last = lastSectionRange.load(std::memory_order_relaxed);
+	if(last < sectionRanges.size())
+	{
+		const SectionRange& r = sectionRanges[last];
+		if(rva >= r.start && end <= (raw ? r.rawEnd : r.virtEnd))
+			return r.sec;
+	}
+
+	// without overlaps, only the last section starting at or before rva can contain
+	// the range, unless there are empty sections at the same address
+	size_t hi = std::upper_bound(sectionRanges.begin(), sectionRanges.end(), rva,
+	                             [](unsigned long a, const SectionRange& r) { return a < r.start; }) - sectionRanges.begin();
+	if(hi == 0)
+		return -1;
+	size_t lo = hi - 1;
+	while(lo > 0 && sectionRanges[lo - 1].start == sectionRanges[hi - 1].start)
+		lo--;
+	for(size_t i = lo; i < hi; i++)
+		if(end <= (raw ? sectionRanges[i].rawEnd : sectionRanges[i].virtEnd))
+		{
+			lastSectionRange.store(i, std::memory_order_relaxed);
+			return sectionRanges[i].sec;
+		}
+	return -1;
+}
+
+int PEImage::findSection(unsigned int off) const
+{
+	off -= IMGHDR(OptionalHeader.ImageBase);
+	return findSectionRange(off, 1, false);
+}
+
+size_t PEImage::SymbolNameHash::operator()(const SymbolName& name) const
+{
+	// FNV-1a
+	size_t h = 2166136261U;
+	for(size_t i = 0; i < name.len; i++)
+		h = (h ^ (unsigned char) name.ptr[i]) * 16777619U;
+	return h;
+}
+
+void PEImage::buildSymbolIndex() const
+{
+	symbolIndexBuilt = true;
+	if(elf)
+		return buildELFSymbolIndex();
+
+	int syms = IMGHDR(FileHeader.NumberOfSymbols);
+	IMAGE_SYMBOL* symtable = DPV<IMAGE_SYMBOL>(IMGHDR(FileHeader.PointerToSymbolTable), syms * IMAGE_SIZEOF_SYMBOL);
+	if(!symtable)
+		return;
+
+	const char* strtable = (const char*) (symtable + syms);
+	symbolIndex.reserve(2 * syms);
+	for(int i = 0; i < syms; i += 1 + symtable[i].NumberOfAuxSymbols)
+	{
+		IMAGE_SYMBOL* sym = symtable + i;
+		SymbolName name;
+		if(sym->N.Name.Short == 0)
+		{
+			name.ptr = strtable + sym->N.Name.Long;
+			name.len = strlen(name.ptr);
+		}
+		else
+		{
+			name.ptr = (const char*) sym->N.ShortName;
+			const void* end = memchr(name.ptr, 0, 8);
+			name.len = end ? (const char*) end - name.ptr : 8;
+		}
+
+		// undefined, absolute and debug symbols have no section
+		if(sym->SectionNumber <= 0)
+			continue;
+
+		// the first symbol matching either name wins, as in a sequential search
+		SymbolLocation loc = { sym->SectionNumber - 1, sym->Value };
+		symbolIndex.insert(std::make_pair(name, loc));
+		if(name.len > 0 && name.ptr[0] == '_')
+		{
+			name.ptr++;
+			name.len--;
+			symbolIndex.insert(std::make_pair(name, loc));
+		}
+	}
+}
+
+int PEImage::findSymbol(const char* name, unsigned long& off) const
+{
+	if(!symbolIndexBuilt)
+		buildSymbolIndex();
+
+	SymbolName key = { name, strlen(name) };
+	symbolIndex_t::const_iterator it = symbolIndex.find(key);
+	if(it == symbolIndex.end())
+		return -1;
+	off = it->second.value;
+	return it->second.section;
+}
+
+///////////////////////////////////////////////////////////////////////
+int PEImage::countCVEntries() const
+{
+	return dirHeader ? dirHeader->cDir : 0; 
+}
+
+OMFDirEntry* PEImage::getCVEntry(int i) const
+{
+	return dirEntry + i; 
+}
+
+
+///////////////////////////////////////////////////////////////////////
+// utilities
+void* PEImage::alloc_aligned(unsigned long long size, unsigned int align, unsigned int alignoff)
+{
+	if (align & (align - 1))
+		return 0;
+
+	unsigned int pad = align + sizeof(void*);
+	if (size > (size_t) -1 - pad)
+		return 0; // does not fit into the address space
+	char* p = (char*) malloc((size_t) size + pad);
+	if (!p)
+		return 0;
+	unsigned int off = (align + alignoff - sizeof(void*) - (unsigned int) (size_t) p) & (align - 1);
+	char* q = p + sizeof(void*) + off;
+	((void**) q)[-1] = p;
+	return q;
+}
+
+///////////////////////////////////////////////////////////////////////
+void PEImage::free_aligned(void* p)
+{
+	void* q = ((void**) p)[-1];
+	free(q);
+}
@@ -1,117 +1,203 @@
-// Convert DMD CodeView debug information to PDB files
-// Copyright (c) 2009-2010 by Rainer Schuetze, All Rights Reserved
-//
-// License for redistribution is given by the Artistic License 2.0
-// see file LICENSE for further details
-
-#ifndef __PEIMAGE_H__
-#define __PEIMAGE_H__
-
-#include "LastError.h"
-
-#include <windows.h>
-
-struct OMFDirHeader;
-struct OMFDirEntry;
-
-#define IMGHDR(x) (hdr32 ? hdr32->x : hdr64->x)
-
-class PEImage : public LastError
-{
-public:
-	PEImage(const TCHAR* iname = 0);
-	~PEImage();
-
-	template<class P> P* DP(int off) const
-	{
-		return (P*) ((char*) dump_base + off); 
-	}
-	template<class P> P* DPV(int off, int size) const
-	{ 
-		if(off < 0 || off + size > dump_total_len)
-			return 0;
-		return (P*) ((char*) dump_base + off); 
-	}
-	template<class P> P* DPV(int off) const
-	{
-		return DPV<P>(off, sizeof(P));
-	}
-	template<class P> P* CVP(int off) const
-	{
-		return DPV<P>(cv_base + off, sizeof(P));
-	}
-
-	template<class P> P* RVA(unsigned long rva, int len)
-	{
-		IMAGE_DOS_HEADER *dos = DPV<IMAGE_DOS_HEADER> (0);
-		IMAGE_NT_HEADERS32* hdr = DPV<IMAGE_NT_HEADERS32> (dos->e_lfanew);
-		IMAGE_SECTION_HEADER* sec = IMAGE_FIRST_SECTION(hdr);
-
-		for (int i = 0; i < hdr->FileHeader.NumberOfSections; i++)
-		{
-			if (rva       >= sec[i].VirtualAddress &&
-				rva + len <= sec[i].VirtualAddress + sec[i].SizeOfRawData)
-				return DPV<P>(sec[i].PointerToRawData + rva - sec[i].VirtualAddress, len);
-		}
-		return 0;
-	}
-
-	bool load(const TCHAR* iname);
-	bool save(const TCHAR* oname);
-
-	bool replaceDebugSection (const void* data, int datalen, bool initCV);
-	bool initCVPtr(bool initDbgDir);
-	bool initDWARFPtr(bool initDbgDir);
-
-	bool hasDWARF() const { return debug_line != 0; }
-	bool isX64() const { return hdr64 != 0; }
-
-	int countCVEntries() const;
-	OMFDirEntry* getCVEntry(int i) const;
-
-	int getCVSize() const { return dbgDir->SizeOfData; }
-
-	// utilities
-	static void* alloc_aligned(unsigned int size, unsigned int align, unsigned int alignoff = 0);
-	static void free_aligned(void* p);
-
-	int countSections() const { return IMGHDR(FileHeader.NumberOfSections); }
-	int findSection(unsigned int off) const;
-	int findSymbol(const char* name, unsigned long& off) const;
-	const IMAGE_SECTION_HEADER& getSection(int s) const { return sec[s]; }
-	unsigned long long getImageBase() const { return IMGHDR(OptionalHeader.ImageBase); }
-
-private:
-	int fd;
-	void* dump_base;
-	int dump_total_len;
-
-	// codeview
-	IMAGE_DOS_HEADER *dos;
-	IMAGE_NT_HEADERS32* hdr32;
-	IMAGE_NT_HEADERS64* hdr64;
-	IMAGE_SECTION_HEADER* sec;
-	IMAGE_DEBUG_DIRECTORY* dbgDir;
-	OMFDirHeader* dirHeader;
-	OMFDirEntry* dirEntry;
-	
-public:
-	//dwarf
-	char* debug_aranges;
-	char* debug_pubnames;
-	char* debug_pubtypes;
-	char* debug_info;     unsigned long debug_info_length;
-	char* debug_abbrev;   unsigned long debug_abbrev_length;
-	char* debug_line;     unsigned long debug_line_length;
-	char* debug_frame;
-	char* debug_str;
-	char* debug_loc;
-	char* debug_ranges;   unsigned long debug_ranges_length;
-	char* reloc;          unsigned long reloc_length;
-
-	int codeSegment;
-	int cv_base;
-};
-
-
+// Convert DMD CodeView debug information to PDB files
+// Copyright (c) 2009-2010 by Rainer Schuetze, All Rights Reserved
+//
+// License for redistribution is given by the Artistic License 2.0
+// see file LICENSE for further details
+
+#ifndef __PEIMAGE_H__
+#define __PEIMAGE_H__
+
+#include "LastError.h"
+
+#include "pecoff.h"
+#include <vector>
+#include <unordered_map>
+#include <atomic>
+
+struct OMFDirHeader;
+struct OMFDirEntry;
+struct ELFSection;
+
+#define IMGHDR(x) (hdr32 ? hdr32->x : hdr64->x)
+
+class PEImage : public LastError
+{
+public:
+	PEImage(const TCHAR* iname = 0);
+	~PEImage();
+
+	// file offsets and sizes are 64-bit to avoid overflow in images larger than 2 GB
+	template<class P> P* DP(unsigned long long off) const
+	{
+		return (P*) ((char*) dump_base + off); 
+	}
+	template<class P> P* DPV(long long off, long long size) const
+	{ 
+		if(off < 0 || size < 0 || (unsigned long long) (off + size) > dump_total_len)
+			return 0;
+		return (P*) ((char*) dump_base + off); 
+	}
+	template<class P> P* DPV(long long off) const
+	{
+		return DPV<P>(off, sizeof(P));
+	}
+	template<class P> P* CVP(long long off) const
+	{
+		return DPV<P>(cv_base + off, sizeof(P));
+	}
+
+	template<class P> P* RVA(unsigned long rva, int len)
+	{
+		int s = findSectionRange(rva, len, true);
+		if (s < 0)
+			return 0;
+		return DPV<P>((long long) sec[s].PointerToRawData + (rva - sec[s].VirtualAddress), len);
+	}
+
+	bool load(const TCHAR* iname);
+	bool loadMemory(const void* data, unsigned long long size);
+	bool save(const TCHAR* oname);
+
+	// the image as it would be written by save
+	const void* getData() const { return dump_base; }
+	unsigned long long getDataSize() const { return dump_total_len; }
+
+	bool replaceDebugSection (const void* data, unsigned long datalen, bool initCV);
+	bool initPtr();
+	bool initCVPtr(bool initDbgDir);
+	bool initDWARFPtr(bool initDbgDir);
+	bool initELFPtr();
+
+	bool hasDWARF() const { return debug_line != 0; }
+	bool isELF() const { return elf; }
+	bool isX64() const { return hdr64 != 0; }
+
+	// signature of the CodeView RSDS record of the debug directory, if any
+	bool findRSDS(GUID& guid, unsigned long& age);
+
+	int countCVEntries() const;
+	OMFDirEntry* getCVEntry(int i) const;
+
+	int getCVSize() const { return dbgDir->SizeOfData; }
+
+	// utilities
+	static void* alloc_aligned(unsigned long long size, unsigned int align, unsigned int alignoff = 0);
+	static void free_aligned(void* p);
+
+	int countSections() const { return IMGHDR(FileHeader.NumberOfSections); }
+	int findSection(unsigned int off) const;
+	int findSymbol(const char* name, unsigned long& off) const;
+	const IMAGE_SECTION_HEADER& getSection(int s) const { return sec[s]; }
+	unsigned long long getImageBase() const { return IMGHDR(OptionalHeader.ImageBase); }
+
+private:
+	int fd;
+	void* dump_base;
+	unsigned long long dump_total_len;
+
+	// codeview
+	IMAGE_DOS_HEADER *dos;
+	IMAGE_NT_HEADERS32* hdr32;
+	IMAGE_NT_HEADERS64* hdr64;
+	IMAGE_SECTION_HEADER* sec;
+	IMAGE_DEBUG_DIRECTORY* dbgDir;
+	OMFDirHeader* dirHeader;
+	OMFDirEntry* dirEntry;
+
+	// compressed DWARF sections, decompressed into owned buffers after all sections are found
+	struct CompressedSection
+	{
+		const unsigned char* data; // zlib stream
+		unsigned long length;
+		unsigned long long size;   // uncompressed
+		char** ptr;                // debug_* member receiving the data
+		unsigned long* ptr_length;
+	};
+	std::vector<CompressedSection> compressedSections;
+	std::vector<char*> decompressed;
+
+	// sections sorted by virtual address, rebuilt whenever the section headers are (re)located
+	struct SectionRange
+	{
+		unsigned long start;   // VirtualAddress
+		unsigned long virtEnd; // start + Misc.VirtualSize
+		unsigned long rawEnd;  // start + SizeOfRawData
+		int sec;
+	};
+	std::vector<SectionRange> sectionRanges;
+	mutable std::atomic<size_t> lastSectionRange; // sequential lookups usually hit the same section
+	bool sectionsOverlap; // lookups search the section headers in order instead
+
+	void initSectionRanges();
+	// section containing [rva,rva+len) in memory (raw = false) or in the file (raw = true)
+	int findSectionRange(unsigned long rva, unsigned long len, bool raw) const;
+
+	bool findDWARFSection(const char* name, char**& ptr, unsigned long*& length);
+	bool addCompressedSection(const char* name, const unsigned char* zdata, unsigned long zlength, unsigned long long size);
+	bool addGNUCompressedSection(const char* name, const char* data, unsigned long length);
+	bool decompressSections();
+
+	// COFF symbols by name, with and without leading underscore, built on first use of findSymbol
+	struct SymbolName
+	{
+		const char* ptr; // not zero terminated for short names
+		size_t len;
+		bool operator==(const SymbolName& other) const
+		{
+			return len == other.len && memcmp(ptr, other.ptr, len) == 0;
+		}
+	};
+	struct SymbolNameHash
+	{
+		size_t operator()(const SymbolName& name) const;
+	};
+	struct SymbolLocation
+	{
+		int section;
+		unsigned long value;
+	};
+	typedef std::unordered_map<SymbolName, SymbolLocation, SymbolNameHash> symbolIndex_t;
+	mutable symbolIndex_t symbolIndex;
+	mutable bool symbolIndexBuilt;
+
+	void buildSymbolIndex() const;
+
+	// ELF input, PE headers are synthesized for the allocated sections
+	bool elf;
+	bool elf64;
+	unsigned long long elfSectionTable;
+	int elfSectionSize;
+	std::vector<char> elfHeaders;
+	std::vector<int> elfSectionMap; // ELF section index to PE section, -1 if not allocated
+	const char* elfSymbols;
+	unsigned long elfSymbolCount;
+	const char* elfSymbolNames;
+	unsigned long long elfSymbolNamesLength;
+
+	bool readELFSection(int idx, ELFSection& es) const;
+	void buildELFSymbolIndex() const;
+
+public:
+	//dwarf
+	char* debug_aranges;  unsigned long debug_aranges_length;
+	char* debug_pubnames; unsigned long debug_pubnames_length;
+	char* debug_pubtypes; unsigned long debug_pubtypes_length;
+	char* debug_info;     unsigned long debug_info_length;
+	char* debug_abbrev;   unsigned long debug_abbrev_length;
+	char* debug_line;     unsigned long debug_line_length;
+	char* debug_frame;
+	char* debug_str;      unsigned long debug_str_length;
+	char* debug_loc;      unsigned long debug_loc_length;
+	char* debug_ranges;   unsigned long debug_ranges_length;
+	char* debug_line_str; unsigned long debug_line_str_length;    // DWARF 5
+	char* debug_str_offsets; unsigned long debug_str_offsets_length;
+	char* debug_addr;     unsigned long debug_addr_length;
+	char* debug_rnglists; unsigned long debug_rnglists_length;
+	char* reloc;          unsigned long reloc_length;
+
+	int codeSegment;
+	unsigned long cv_base;
+};
+
+
 #endif //__PEIMAGE_H__
\ No newline at end of file
@@ -0,0 +1,248 @@
+// Convert DMD CodeView/DWARF debug information to PDB files
+// Copyright (c) 2009-2012 by Rainer Schuetze, All Rights Reserved
+//
+// License for redistribution is given by the Artistic License 2.0
+// see file LICENSE for further details
+
+#include "convert.h"
+#include "PEImage.h"
+#include "cv2pdb.h"
+#include "symutil.h"
+#include "cufilter.h"
+#include "pdbfile.h"
+#include "stats.h"
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <vector>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#ifdef UNICODE
+#define T_unlink	_wremove
+#define T_fopen		_wfopen
+#define SARG		"%S"
+#else
+#define T_unlink	unlink
+#define T_fopen		fopen
+#define SARG		"%s"
+#endif
+
+ConvertOptions::ConvertOptions()
+: Dversion(2.043)
+, demangleSymbols(true)
+, useTypedefEnum(false)
+, dotReplacementChar('@')
+, pdbref(0)
+, cuFilter(0)
+, memoryBudget(0)
+, lineTablesOnly(false)
+, keepImage(false)
+, guid(0)
+, age(1)
+{
+}
+
+Converter::Converter(const ConvertOptions& opts)
+: options(opts)
+{
+	errorMessage[0] = 0;
+}
+
+// format the error message, always returns false
+bool Converter::failed(const char* message, ...)
+{
+	va_list argptr;
+	va_start(argptr, message);
+	vsnprintf(errorMessage, sizeof(errorMessage), message, argptr);
+	va_end(argptr);
+	errorMessage[sizeof(errorMessage) - 1] = 0; // not terminated by older CRTs if truncated
+	return setError(errorMessage);
+}
+
+// signature of the PDB for an image that is not rewritten
+bool Converter::findSignature(PEImage& img, const TCHAR* exename, GUID& guid, unsigned long& age)
+{
+	if (!img.hasDWARF())
+		return failed(SARG ": the CodeView debug information must be replaced in the image", exename);
+	if (options.guid)
+	{
+		guid = *options.guid;
+		age = options.age;
+		return true;
+	}
+	if (!img.findRSDS(guid, age))
+		return failed(SARG ": no RSDS debug directory entry found, the PDB signature must be specified", exename);
+	return true;
+}
+
+bool Converter::setPDBSignature(const TCHAR* pdbname, const GUID& guid, unsigned long age)
+{
+	PDBFile pdb;
+	if (!STAT_PHASE("setPDBSignature", pdb.setSignature(pdbname, guid, age)))
+		return failed(SARG ": %s", pdbname, pdb.getLastError());
+	return true;
+}
+
+static bool readFile(const TCHAR* fname, std::vector<char>& data)
+{
+	FILE* fh = T_fopen(fname, TEXT("rb"));
+	if (!fh)
+		return false;
+	char buf[0x10000];
+	size_t len;
+	while ((len = fread(buf, 1, sizeof(buf), fh)) > 0)
+		data.insert(data.end(), buf, buf + len);
+	bool ok = !ferror(fh);
+	fclose(fh);
+	return ok;
+}
+
+///////////////////////////////////////////////////////////////////////
+bool Converter::convertFile(const TCHAR* exename, const TCHAR* outname, const TCHAR* pdbname)
+{
+	PEImage img;
+	if (!STAT_PHASE("load", img.load(exename)))
+		return failed(SARG ": %s", exename, img.getLastError());
+
+	return convert(img, exename, outname && outname[0] ? outname : exename, pdbname);
+}
+
+bool Converter::convertMemory(const void* image, unsigned long long size, const TCHAR* pdbname,
+                              ConvertOutput imageOutput, ConvertOutput pdbOutput, void* context)
+{
+	const TCHAR* exename = TEXT("<image>");
+	PEImage img;
+	if (!STAT_PHASE("load", img.loadMemory(image, size)))
+		return failed(SARG ": %s", exename, img.getLastError());
+
+	if (!convert(img, exename, 0, pdbname))
+		return false;
+
+	if (imageOutput && !img.isELF() && !imageOutput(context, img.getData(), img.getDataSize()))
+		return failed(SARG ": image output failed", exename);
+
+	if (pdbOutput)
+	{
+		std::vector<char> pdb;
+		if (!readFile(pdbname, pdb))
+			return failed(SARG ": cannot read PDB file", pdbname);
+		if (!pdbOutput(context, pdb.empty() ? 0 : &pdb[0], pdb.size()))
+			return failed(SARG ": PDB output failed", pdbname);
+	}
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////
+// outname might be 0 to keep the converted image in memory only
+bool Converter::convert(PEImage& img, const TCHAR* exename, const TCHAR* outname, const TCHAR* pdbname)
+{
+	if (img.countCVEntries() == 0 && !img.hasDWARF())
+		return failed(SARG ": no codeview debug entries found", exename);
+
+	// the symbol name conversion is configured through globals in symutil
+	demangleSymbols = options.demangleSymbols;
+	useTypedefEnum = options.useTypedefEnum;
+	dotReplacementChar = options.dotReplacementChar;
+
+	CUFilter* cuFilter = options.cuFilter && !options.cuFilter->empty() ? options.cuFilter : 0;
+
+	GUID guid;
+	unsigned long age = 0;
+	if (options.keepImage && !findSignature(img, exename, guid, age))
+		return false;
+
+	CV2PDB cv2pdb(img);
+	cv2pdb.Dversion = options.Dversion;
+	cv2pdb.memoryBudget = (unsigned long long) options.memoryBudget << 20;
+	cv2pdb.lineTablesOnly = options.lineTablesOnly;
+	cv2pdb.initLibraries();
+
+	T_unlink(pdbname);
+
+	if(!STAT_PHASE("openPDB", cv2pdb.openPDB(pdbname, options.pdbref)))
+		return failed(SARG ": %s", pdbname, cv2pdb.getLastError());
+
+	if(img.hasDWARF())
+	{
+		if(!cv2pdb.checkDWARFUnits())
+			return failed(SARG ": %s", exename, cv2pdb.getLastError());
+
+		if (cuFilter)
+		{
+			if (!STAT_PHASE("selectUnits", cuFilter->select(img)))
+				return failed(SARG ": %s", exename, cuFilter->getLastError());
+			cv2pdb.cuFilter = cuFilter;
+		}
+
+		if(!STAT_PHASE("relocateDebugLineInfo", cv2pdb.relocateDebugLineInfo()))
+			return failed(SARG ": %s", exename, cv2pdb.getLastError());
+
+		// line numbers are decoded while the types are converted
+		if(!cv2pdb.startDWARFLines())
+			return failed(SARG ": %s", exename, cv2pdb.getLastError());
+
+		if(!STAT_PHASE("createDWARFModules", cv2pdb.createDWARFModules()))
+			return failed(SARG ": %s", pdbname, cv2pdb.getLastError());
+
+		if(!STAT_PHASE("addDWARFTypes", cv2pdb.addDWARFTypes()))
+			return failed(SARG ": %s", pdbname, cv2pdb.getLastError());
+
+		if(!STAT_PHASE("addDWARFLines", cv2pdb.addDWARFLines()))
+			return failed(SARG ": %s", pdbname, cv2pdb.getLastError());
+
+		if (!STAT_PHASE("addDWARFPublics", cv2pdb.addDWARFPublics()))
+			return failed(SARG ": %s", pdbname, cv2pdb.getLastError());
+
+		if (options.keepImage)
+		{
+			// the signature can only be replaced after the PDB is committed and closed
+			cv2pdb.cleanup(true);
+			if (!setPDBSignature(pdbname, guid, age))
+				return false;
+		}
+		else
+		{
+			// an ELF image has no debug directory to point to the PDB, only the PDB is written
+			if (!img.isELF() && !STAT_PHASE("writeDWARFImage", cv2pdb.writeDWARFImage(outname)))
+				return failed(SARG ": %s", outname ? outname : exename, cv2pdb.getLastError());
+			guid = cv2pdb.rsds->guid;
+			age = cv2pdb.rsds->age;
+		}
+	}
+	else
+	{
+		if (!STAT_PHASE("initSegMap", cv2pdb.initSegMap()))
+			return failed(SARG ": %s", exename, cv2pdb.getLastError());
+
+		if (!STAT_PHASE("initGlobalSymbols", cv2pdb.initGlobalSymbols()))
+			return failed(SARG ": %s", exename, cv2pdb.getLastError());
+
+		if (!STAT_PHASE("initGlobalTypes", cv2pdb.initGlobalTypes()))
+			return failed(SARG ": %s", exename, cv2pdb.getLastError());
+
+		if (!STAT_PHASE("createModules", cv2pdb.createModules()))
+			return failed(SARG ": %s", pdbname, cv2pdb.getLastError());
+
+		if (!STAT_PHASE("addTypes", cv2pdb.addTypes()))
+			return failed(SARG ": %s", pdbname, cv2pdb.getLastError());
+
+		if (!STAT_PHASE("addSymbols", cv2pdb.addSymbols()))
+			return failed(SARG ": %s", pdbname, cv2pdb.getLastError());
+
+		if (!STAT_PHASE("addSrcLines", cv2pdb.addSrcLines()))
+			return failed(SARG ": %s", pdbname, cv2pdb.getLastError());
+
+		if (!STAT_PHASE("addPublics", cv2pdb.addPublics()))
+			return failed(SARG ": %s", pdbname, cv2pdb.getLastError());
+
+		if (!STAT_PHASE("writeImage", cv2pdb.writeImage(outname)))
+			return failed(SARG ": %s", outname ? outname : exename, cv2pdb.getLastError());
+	}
+
+	// the PDB is committed and closed when cv2pdb is destroyed
+	return true;
+}
@@ -0,0 +1,68 @@
+// Convert DMD CodeView/DWARF debug information to PDB files
+// Copyright (c) 2009-2012 by Rainer Schuetze, All Rights Reserved
+//
+// License for redistribution is given by the Artistic License 2.0
+// see file LICENSE for further details
+
+#ifndef __CONVERT_H__
+#define __CONVERT_H__
+
+#include "LastError.h"
+
+#include "pecoff.h"
+
+class PEImage;
+class CUFilter;
+
+// options of a single conversion, the defaults are those of the command line
+struct ConvertOptions
+{
+	ConvertOptions();
+
+	double Dversion;           // 0 for C/C++
+	bool demangleSymbols;
+	bool useTypedefEnum;
+	char dotReplacementChar;
+	const TCHAR* pdbref;       // PDB name stored in the image, 0 for the PDB file name
+	CUFilter* cuFilter;        // convert only the selected units, 0 for all
+	unsigned long memoryBudget; // budget in MB for DWARF symbols, abbreviations and line numbers, 0 for none
+	bool lineTablesOnly;       // DWARF: only procedures, publics and line numbers
+	bool keepImage;            // DWARF: only write the PDB, the image is not modified
+	const GUID* guid;          // keepImage: signature of the PDB, 0 for the RSDS record of the image
+	unsigned long age;
+};
+
+// receives the converted image or PDB, returns false to fail the conversion
+typedef bool (*ConvertOutput)(void* context, const void* data, unsigned long long size);
+
+// entry point for embedding the conversion into other tools, e.g. a linker.
+// The PDB helper DLL is loaded with the first conversion and stays loaded,
+// so converting many images in one process does not pay for it again.
+class Converter : public LastError
+{
+public:
+	Converter(const ConvertOptions& options);
+
+	// convert the image file exename, the image is written to outname
+	// (exename if 0, not at all with keepImage) and the PDB to pdbname (full path)
+	bool convertFile(const TCHAR* exename, const TCHAR* outname, const TCHAR* pdbname);
+
+	// convert an image in memory, the input buffer is not modified. The
+	// image referencing the PDB is passed to imageOutput. The PDB helper
+	// DLL can only write files, so the PDB is created at pdbname (full path)
+	// and its contents are passed to pdbOutput after it has been committed.
+	// Either output might be 0.
+	bool convertMemory(const void* image, unsigned long long size, const TCHAR* pdbname,
+	                   ConvertOutput imageOutput, ConvertOutput pdbOutput, void* context);
+
+private:
+	bool convert(PEImage& img, const TCHAR* exename, const TCHAR* outname, const TCHAR* pdbname);
+	bool failed(const char* message, ...);
+	bool findSignature(PEImage& img, const TCHAR* exename, GUID& guid, unsigned long& age);
+	bool setPDBSignature(const TCHAR* pdbname, const GUID& guid, unsigned long age);
+
+	ConvertOptions options;
+	char errorMessage[1024];
+};
+
+#endif //__CONVERT_H__
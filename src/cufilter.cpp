@@ -0,0 +1,237 @@
+// Convert DMD CodeView/DWARF debug information to PDB files
+// Copyright (c) 2009-2012 by Rainer Schuetze, All Rights Reserved
+//
+// License for redistribution is given by the Artistic License 2.0
+// see file LICENSE for further details
+
+#include "cufilter.h"
+#include "PEImage.h"
+#include "readDwarf.h"
+#include "dwarf.h"
+
+#include <ctype.h>
+
+void CUFilter::addRange(unsigned long lo, unsigned long hi)
+{
+	ranges.push_back(std::make_pair(lo, hi));
+}
+
+void CUFilter::addUnitName(const char* pattern)
+{
+	unitNames.push_back(pattern);
+}
+
+void CUFilter::addPublic(const char* name)
+{
+	publics.insert(name);
+}
+
+bool CUFilter::overlaps(unsigned long lo, unsigned long hi) const
+{
+	for (size_t r = 0; r < ranges.size(); r++)
+		if (lo < ranges[r].second && ranges[r].first < hi)
+			return true;
+	return false;
+}
+
+static bool containsNoCase(const char* s, const std::string& pattern)
+{
+	size_t len = pattern.length();
+	for (; *s; s++)
+	{
+		size_t i = 0;
+		while (i < len && s[i] && tolower((unsigned char)s[i]) == tolower((unsigned char)pattern[i]))
+			i++;
+		if (i == len)
+			return true;
+	}
+	return len == 0;
+}
+
+// .debug_aranges: sets of address ranges, each referring to a compilation unit.
+// Returns false if the table is missing or cannot be used.
+bool CUFilter::selectByAranges(PEImage& img)
+{
+	if (!img.debug_aranges)
+		return false;
+
+	byte* p = (byte*)img.debug_aranges;
+	byte* end = p + img.debug_aranges_length;
+	while (end - p >= 12)
+	{
+		byte* set = p;
+		unsigned int length = RD4(p);
+		if (length == 0)
+			break; // padding
+		if (length == 0xffffffff || length > (unsigned int)(end - p))
+			return false; // DWARF-64 or truncated
+		byte* setEnd = p + length;
+
+		int version = RD2(p);
+		unsigned int infoOff = RD4(p);
+		int addrSize = *p++;
+		int segSize = *p++;
+		if (version != 2 || segSize != 0 || (addrSize != 4 && addrSize != 8))
+			return false; // unknown format or segmented addresses
+
+		// tuples are aligned to twice the address size
+		int align = 2 * addrSize;
+		p = set + (p - set + align - 1) / align * align;
+		while (setEnd - p >= 2 * addrSize)
+		{
+			unsigned long lo = (unsigned long)RDaddr(p, addrSize);
+			unsigned long len = (unsigned long)RDaddr(p, addrSize);
+			if (lo == 0 && len == 0)
+				break;
+			if (overlaps(lo, lo + len))
+				units.insert(infoOff);
+		}
+		p = setEnd;
+	}
+	return true;
+}
+
+// .debug_pubnames and .debug_pubtypes: global names with the offset of their compilation unit.
+// Returns false if the table is missing or cannot be used.
+bool CUFilter::selectByPubnames(const char* sec, unsigned long sec_length)
+{
+	if (!sec)
+		return false;
+
+	byte* p = (byte*)sec;
+	byte* end = p + sec_length;
+	while (end - p >= 14)
+	{
+		unsigned int length = RD4(p);
+		if (length == 0)
+			break; // padding
+		if (length == 0xffffffff || length > (unsigned int)(end - p))
+			return false; // DWARF-64 or truncated
+		byte* setEnd = p + length;
+
+		int version = RD2(p);
+		unsigned int infoOff = RD4(p);
+		p += 4; // length of the compilation unit
+		if (version != 2)
+			return false;
+		while (setEnd - p > 4)
+		{
+			unsigned int dieOff = RD4(p);
+			if (dieOff == 0)
+				break;
+			const char* name = (const char*)p;
+			while (p < setEnd && *p)
+				p++;
+			if (p >= setEnd)
+				break;
+			p++;
+			if (publics.count(name))
+				units.insert(infoOff);
+		}
+		p = setEnd;
+	}
+	return true;
+}
+
+bool CUFilter::matchesName(const DWARF_DIEView& die) const
+{
+	DWARF_Attribute name, dir;
+	bool hasName = die.getAttr(DW_AT_name, name) && name.type == String;
+	bool hasDir = die.getAttr(DW_AT_comp_dir, dir) && dir.type == String;
+	for (size_t n = 0; n < unitNames.size(); n++)
+	{
+		if (hasName && containsNoCase(name.string, unitNames[n]))
+			return true;
+		if (hasDir && containsNoCase(dir.string, unitNames[n]))
+			return true;
+	}
+	return false;
+}
+
+// without .debug_aranges, use the address range of the unit DIE
+bool CUFilter::matchesRange(PEImage& img, const DWARF_DIEView& die) const
+{
+	DWARF_Attribute lo, hi, rng;
+	if (!die.getAttr(DW_AT_low_pc, lo) || lo.type != Addr)
+		return false;
+
+	if (die.getAttr(DW_AT_high_pc, hi))
+	{
+		unsigned long pchi = hi.type == Addr ? hi.addr : hi.type == Const ? lo.addr + hi.cons : lo.addr;
+		return overlaps(lo.addr, pchi);
+	}
+	std::vector<DWARF_Range> rngs;
+	if (die.getAttr(DW_AT_ranges, rng) && rng.type == SecOffset && readDWARFRanges(die.cu, rng.sec_offset, rngs))
+	{
+		for (size_t r = 0; r < rngs.size(); r++)
+			if (overlaps(rngs[r].pclo, rngs[r].pchi))
+				return true;
+	}
+	return false;
+}
+
+// without .debug_pubnames, look at the names of the top level DIEs
+bool CUFilter::definesPublic(DIECursor cursor) const
+{
+	DIECursor children = cursor.getSubtreeCursor();
+	DWARF_DIEView die;
+	while (children.readSibling(die))
+	{
+		DWARF_Attribute a;
+		if (die.getAttr(DW_AT_MIPS_linkage_name, a) && a.type == String && publics.count(a.string))
+			return true;
+		if (die.getAttr(DW_AT_name, a) && a.type == String && publics.count(a.string))
+			return true;
+	}
+	return false;
+}
+
+bool CUFilter::select(PEImage& img)
+{
+	units.clear();
+	lines.clear();
+	if (!img.debug_info)
+		return setError("no .debug_info section found");
+
+	bool useAranges = !ranges.empty() && selectByAranges(img);
+	bool usePubnames = false;
+	if (!publics.empty())
+	{
+		usePubnames = selectByPubnames(img.debug_pubnames, img.debug_pubnames_length);
+		if (usePubnames)
+			selectByPubnames(img.debug_pubtypes, img.debug_pubtypes_length);
+	}
+
+	DIECursor::setContext(&img);
+
+	// only the unit DIE is read, unless one of the tables is missing
+	for (unsigned long off = 0; off + sizeof(DWARF_CompilationUnit) <= img.debug_info_length; )
+	{
+		DWARF_CompilationUnit* cu = (DWARF_CompilationUnit*)(img.debug_info + off);
+		DIECursor cursor(cu, cu->firstDIE());
+		DWARF_DIEView die;
+		if (cu->isCompileUnit() && cursor.readNext(die))
+		{
+			bool selected = units.count(off) != 0;
+			if (!selected && !unitNames.empty())
+				selected = matchesName(die);
+			if (!selected && !ranges.empty() && !useAranges)
+				selected = matchesRange(img, die);
+			if (!selected && !publics.empty() && !usePubnames)
+				selected = definesPublic(cursor);
+
+			DWARF_Attribute stmt;
+			if (selected)
+			{
+				units.insert(off);
+				if (die.getAttr(DW_AT_stmt_list, stmt))
+					lines.insert(stmt.type == SecOffset ? stmt.sec_offset : stmt.cons);
+			}
+		}
+		off += sizeof(cu->unit_length) + cu->unit_length;
+	}
+
+	if (units.empty())
+		return setError("no compilation unit matches the selection");
+	return true;
+}
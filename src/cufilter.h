@@ -0,0 +1,58 @@
+// Convert DMD CodeView/DWARF debug information to PDB files
+// Copyright (c) 2009-2012 by Rainer Schuetze, All Rights Reserved
+//
+// License for redistribution is given by the Artistic License 2.0
+// see file LICENSE for further details
+
+#ifndef __CUFILTER_H__
+#define __CUFILTER_H__
+
+#include "LastError.h"
+
+#include <vector>
+#include <string>
+#include <set>
+
+class PEImage;
+struct DWARF_DIEView;
+class DIECursor;
+
+// selects the DWARF compilation units to convert: units overlapping any of
+// the address ranges, units with a matching name or compilation directory,
+// or units defining any of the public names. The accelerator tables
+// .debug_aranges and .debug_pubnames are used if available, so only the
+// root DIE of the other units is read.
+class CUFilter : public LastError
+{
+public:
+	void addRange(unsigned long lo, unsigned long hi); // virtual addresses [lo,hi)
+	void addUnitName(const char* pattern);             // case insensitive substring
+	void addPublic(const char* name);
+
+	bool empty() const { return ranges.empty() && unitNames.empty() && publics.empty(); }
+
+	// determine the selected units of the image, fails if none matches
+	bool select(PEImage& img);
+
+	// off: offset of the unit in .debug_info or of the line number program in .debug_line
+	bool isUnitSelected(unsigned long off) const { return units.count(off) != 0; }
+	bool isLineSelected(unsigned long off) const { return lines.count(off) != 0; }
+	int countSelected() const { return units.size(); }
+
+private:
+	bool overlaps(unsigned long lo, unsigned long hi) const;
+	bool selectByAranges(PEImage& img);
+	bool selectByPubnames(const char* sec, unsigned long length);
+	bool matchesName(const DWARF_DIEView& die) const;
+	bool matchesRange(PEImage& img, const DWARF_DIEView& die) const;
+	bool definesPublic(DIECursor cursor) const;
+
+	std::vector<std::pair<unsigned long, unsigned long> > ranges;
+	std::vector<std::string> unitNames;
+	std::set<std::string> publics;
+
+	std::set<unsigned long> units;
+	std::set<unsigned long> lines;
+};
+
+#endif //__CUFILTER_H__
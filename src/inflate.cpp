@@ -0,0 +1,349 @@
+// Convert DMD CodeView/DWARF debug information to PDB files
+// Copyright (c) 2009-2012 by Rainer Schuetze, All Rights Reserved
+//
+// License for redistribution is given by the Artistic License 2.0
+// see file LICENSE for further details
+
+#include "inflate.h"
+
+#include <string.h>
+
+static const int kMaxBits = 15;
+static const int kFastBits = 10;
+static const int kMaxLitCodes = 288;
+static const int kMaxDistCodes = 30;
+
+// canonical Huffman code, codes up to kFastBits are decoded with a single table lookup
+struct Huffman
+{
+	unsigned short count[kMaxBits + 1];  // number of codes of each length
+	unsigned short symbol[kMaxLitCodes]; // symbols ordered by code
+	unsigned short fast[1 << kFastBits]; // (length << 9) | symbol, 0 for longer codes
+
+	bool build(const unsigned char* lengths, int n)
+	{
+		memset(count, 0, sizeof(count));
+		for (int s = 0; s < n; s++)
+			count[lengths[s]]++;
+		count[0] = 0;
+
+		int left = 1;
+		for (int len = 1; len <= kMaxBits; len++)
+		{
+			left <<= 1;
+			left -= count[len];
+			if (left < 0)
+				return false; // over-subscribed, incomplete codes are allowed
+		}
+
+		unsigned short offs[kMaxBits + 2];
+		offs[1] = 0;
+		for (int len = 1; len <= kMaxBits; len++)
+			offs[len + 1] = offs[len] + count[len];
+		for (int s = 0; s < n; s++)
+			if (lengths[s])
+				symbol[offs[lengths[s]]++] = s;
+
+		memset(fast, 0, sizeof(fast));
+		unsigned code = 0;
+		int idx = 0;
+		for (int len = 1; len <= kFastBits; len++)
+		{
+			for (int k = 0; k < count[len]; k++, code++)
+			{
+				unsigned rev = 0;
+				for (int b = 0; b < len; b++)
+					rev |= ((code >> b) & 1) << (len - 1 - b);
+				unsigned short entry = (unsigned short)((len << 9) | symbol[idx++]);
+				for (unsigned j = rev; j < (1u << kFastBits); j += 1u << len)
+					fast[j] = entry;
+			}
+			code <<= 1;
+		}
+		return true;
+	}
+};
+
+struct Inflater
+{
+	const unsigned char* in;
+	const unsigned char* inend;
+	unsigned char* out;
+	unsigned char* outbase;
+	unsigned char* outend;
+
+	unsigned long long bitbuf;
+	int bitcnt;
+	int padded; // bytes added beyond the end of the input
+
+	void refill()
+	{
+		while (bitcnt <= 56)
+		{
+			if (in < inend)
+				bitbuf |= (unsigned long long)*in++ << bitcnt;
+			else
+				padded++;
+			bitcnt += 8;
+		}
+	}
+
+	// only valid after consuming bits, reading into the padding is an error
+	bool overrun() const { return bitcnt < padded * 8; }
+
+	unsigned bits(int n)
+	{
+		if (bitcnt < n)
+			refill();
+		unsigned v = (unsigned)(bitbuf & ((1ull << n) - 1));
+		bitbuf >>= n;
+		bitcnt -= n;
+		return v;
+	}
+
+	int decode(const Huffman& h)
+	{
+		if (bitcnt < kMaxBits)
+			refill();
+		unsigned short e = h.fast[bitbuf & ((1 << kFastBits) - 1)];
+		if (e)
+		{
+			bitbuf >>= e >> 9;
+			bitcnt -= e >> 9;
+			return e & 0x1ff;
+		}
+
+		// bit by bit for long codes
+		int code = 0, first = 0, index = 0;
+		for (int len = 1; len <= kMaxBits; len++)
+		{
+			code |= (int)(bitbuf & 1);
+			bitbuf >>= 1;
+			bitcnt--;
+			int count = h.count[len];
+			if (code - count < first)
+				return h.symbol[index + (code - first)];
+			index += count;
+			first += count;
+			first <<= 1;
+			code <<= 1;
+		}
+		return -1;
+	}
+
+	bool stored()
+	{
+		// drop the bits up to the byte boundary and return unused bytes to the input
+		bits(bitcnt & 7);
+		in -= bitcnt / 8 - padded;
+		bitbuf = 0;
+		bitcnt = 0;
+		padded = 0;
+
+		if (inend - in < 4)
+			return false;
+		unsigned len = in[0] | (in[1] << 8);
+		unsigned nlen = in[2] | (in[3] << 8);
+		in += 4;
+		if (len != (~nlen & 0xffff))
+			return false;
+		if ((unsigned long)(inend - in) < len || (unsigned long)(outend - out) < len)
+			return false;
+		memcpy(out, in, len);
+		in += len;
+		out += len;
+		return true;
+	}
+
+	bool codes(const Huffman& lit, const Huffman& dist)
+	{
+		static const unsigned short lbase[29] = {
+			3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+			35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+		static const unsigned char lext[29] = {
+			0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+			3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+		static const unsigned short dbase[30] = {
+			1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+			257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+		static const unsigned char dext[30] = {
+			0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+			7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+		for (;;)
+		{
+			int sym = decode(lit);
+			if (sym < 0 || overrun())
+				return false;
+			if (sym < 256)
+			{
+				if (out >= outend)
+					return false;
+				*out++ = (unsigned char)sym;
+				continue;
+			}
+			if (sym == 256)
+				return true;
+
+			sym -= 257;
+			if (sym >= 29)
+				return false;
+			unsigned len = lbase[sym] + bits(lext[sym]);
+			int dsym = decode(dist);
+			if (dsym < 0 || dsym >= 30)
+				return false;
+			unsigned d = dbase[dsym] + bits(dext[dsym]);
+			if (overrun() || d > (unsigned long)(out - outbase) || len > (unsigned long)(outend - out))
+				return false;
+
+			const unsigned char* from = out - d;
+			if (d >= len)
+			{
+				memcpy(out, from, len);
+				out += len;
+			}
+			else
+				for (unsigned i = 0; i < len; i++)
+					*out++ = from[i];
+		}
+	}
+
+	bool fixed()
+	{
+		static Huffman lit, dist;
+		static bool init = false;
+		if (!init)
+		{
+			unsigned char lengths[kMaxLitCodes];
+			int s = 0;
+			for (; s < 144; s++) lengths[s] = 8;
+			for (; s < 256; s++) lengths[s] = 9;
+			for (; s < 280; s++) lengths[s] = 7;
+			for (; s < 288; s++) lengths[s] = 8;
+			lit.build(lengths, kMaxLitCodes);
+			for (s = 0; s < kMaxDistCodes; s++)
+				lengths[s] = 5;
+			dist.build(lengths, kMaxDistCodes);
+			init = true;
+		}
+		return codes(lit, dist);
+	}
+
+	bool dynamic()
+	{
+		static const unsigned char order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+		int nlen = bits(5) + 257;
+		int ndist = bits(5) + 1;
+		int ncode = bits(4) + 4;
+		if (nlen > kMaxLitCodes || ndist > kMaxDistCodes)
+			return false;
+
+		unsigned char lengths[kMaxLitCodes + kMaxDistCodes];
+		memset(lengths, 0, 19);
+		for (int i = 0; i < ncode; i++)
+			lengths[order[i]] = bits(3);
+
+		Huffman lencode;
+		if (!lencode.build(lengths, 19))
+			return false;
+
+		int idx = 0;
+		while (idx < nlen + ndist)
+		{
+			int sym = decode(lencode);
+			if (sym < 0 || overrun())
+				return false;
+			if (sym < 16)
+			{
+				lengths[idx++] = sym;
+				continue;
+			}
+			int len = 0, rep;
+			if (sym == 16)
+			{
+				if (idx == 0)
+					return false;
+				len = lengths[idx - 1];
+				rep = 3 + bits(2);
+			}
+			else if (sym == 17)
+				rep = 3 + bits(3);
+			else
+				rep = 11 + bits(7);
+			if (idx + rep > nlen + ndist)
+				return false;
+			while (rep--)
+				lengths[idx++] = len;
+		}
+		if (lengths[256] == 0)
+			return false; // no end of block code
+
+		Huffman lit, dist;
+		if (!lit.build(lengths, nlen) || !dist.build(lengths + nlen, ndist))
+			return false;
+		return codes(lit, dist);
+	}
+
+	bool run()
+	{
+		bitbuf = 0;
+		bitcnt = 0;
+		padded = 0;
+
+		int last;
+		do
+		{
+			last = bits(1);
+			int type = bits(2);
+			bool ok = type == 0 ? stored() : type == 1 ? fixed() : type == 2 ? dynamic() : false;
+			if (!ok || overrun())
+				return false;
+		} while (!last);
+
+		// return unused bytes to the input for the checksum
+		bits(bitcnt & 7);
+		in -= bitcnt / 8 - padded;
+		return true;
+	}
+};
+
+static unsigned long adler32(const unsigned char* p, unsigned long len)
+{
+	unsigned long a = 1, b = 0;
+	while (len > 0)
+	{
+		unsigned long n = len < 5552 ? len : 5552;
+		len -= n;
+		for (; n > 0; n--)
+		{
+			a += *p++;
+			b += a;
+		}
+		a %= 65521;
+		b %= 65521;
+	}
+	return (b << 16) | a;
+}
+
+bool inflateZlib(const unsigned char* src, unsigned long srclen, unsigned char* dst, unsigned long dstlen)
+{
+	if (srclen < 6)
+		return false;
+	int cmf = src[0], flg = src[1];
+	if ((cmf & 0xf) != 8 || (cmf >> 4) > 7 || ((cmf << 8) | flg) % 31 != 0 || (flg & 0x20))
+		return false; // not deflate or preset dictionary
+
+	Inflater inf;
+	inf.in = src + 2;
+	inf.inend = src + srclen;
+	inf.outbase = inf.out = dst;
+	inf.outend = dst + dstlen;
+	if (!inf.run() || inf.out != inf.outend)
+		return false;
+
+	if (inf.inend - inf.in < 4)
+		return false;
+	unsigned long check = ((unsigned long)inf.in[0] << 24) | (inf.in[1] << 16) | (inf.in[2] << 8) | inf.in[3];
+	return check == adler32(dst, dstlen);
+}
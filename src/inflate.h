@@ -0,0 +1,14 @@
+// Convert DMD CodeView/DWARF debug information to PDB files
+// Copyright (c) 2009-2012 by Rainer Schuetze, All Rights Reserved
+//
+// License for redistribution is given by the Artistic License 2.0
+// see file LICENSE for further details
+
+#ifndef __INFLATE_H__
+#define __INFLATE_H__
+
+// decompress a zlib stream (RFC 1950/1951) into dst, which must receive exactly
+// dstlen bytes. Returns false if the data is corrupt or does not match dstlen.
+bool inflateZlib(const unsigned char* src, unsigned long srclen, unsigned char* dst, unsigned long dstlen);
+
+#endif //__INFLATE_H__
@@ -1,229 +1,717 @@
-// Convert DMD CodeView debug information to PDB files
-// Copyright (c) 2009-2010 by Rainer Schuetze, All Rights Reserved
-//
-// License for redistribution is given by the Artistic License 2.0
-// see file LICENSE for further details
-
-#include "PEImage.h"
-#include "cv2pdb.h"
-#include "symutil.h"
-
-#include <direct.h>
-
-double
-#include "../VERSION"
-;
-
-#ifdef UNICODE
-#define T_toupper	towupper
-#define T_getdcwd	_wgetdcwd
-#define T_strlen	wcslen
-#define T_strcpy	wcscpy
-#define T_strcat	wcscat
-#define T_strstr	wcsstr
-#define T_strtod	wcstod
-#define T_strrchr	wcsrchr
-#define T_unlink	_wremove
-#define T_main		wmain
-#define SARG		"%S"
-#else
-#define T_toupper	toupper
-#define T_getdcwd	_getdcwd
-#define T_strlen	strlen
-#define T_strcpy	strcpy
-#define T_strcat	strcat
-#define T_strstr	strstr
-#define T_strtod	strtod
-#define T_strrchr	strrchr
-#define T_unlink	unlink
-#define T_main		main
-#define SARG		"%s"
-#endif
-
-void fatal(const char *message, ...)
-{
-	va_list argptr;
-	va_start(argptr, message);
-	vprintf(message, argptr);
-	va_end(argptr);
-	printf("\n");
-	exit(1);
-}
-
-void makefullpath(TCHAR* pdbname)
-{
-	TCHAR* pdbstart = pdbname;
-	TCHAR fullname[260];
-	TCHAR* pfullname = fullname;
-
-	int drive = 0;
-	if (pdbname[0] && pdbname[1] == ':')
-	{
-		if (pdbname[2] == '\\' || pdbname[2] == '/')
-			return;
-		drive = T_toupper (pdbname[0]);
-		pdbname += 2;
-	}
-	else
-	{
-		drive = _getdrive();
-	}
-
-	if (*pdbname != '\\' && *pdbname != '/')
-	{
-		T_getdcwd(drive, pfullname, sizeof(fullname)/sizeof(fullname[0]) - 2);
-		pfullname += T_strlen(pfullname);
-		if (pfullname[-1] != '\\')
-			*pfullname++ = '\\';
-	}
-	else
-	{
-		*pfullname++ = 'a' - 1 + drive;
-		*pfullname++ = ':';
-	}
-	T_strcpy(pfullname, pdbname);
-	T_strcpy(pdbstart, fullname);
-
-	for(TCHAR*p = pdbstart; *p; p++)
-		if (*p == '/')
-			*p = '\\';
-
-	// remove relative parts "./" and "../"
-	while (TCHAR* p = T_strstr (pdbstart, TEXT("\\.\\")))
-		T_strcpy(p, p + 2);
-
-	while (TCHAR* p = T_strstr (pdbstart, TEXT("\\..\\")))
-	{
-		for (TCHAR* q = p - 1; q >= pdbstart; q--)
-			if (*q == '\\')
-			{
-				T_strcpy(q, p + 3);
-				break;
-			}
-	}
-}
-
-int T_main(int argc, TCHAR* argv[])
-{
-	PEImage img;
-	double Dversion = 2.043;
-	const TCHAR* pdbref = 0;
-
-	while (argc > 1 && argv[1][0] == '-')
-	{
-		argv++;
-		argc--;
-		if (argv[0][1] == '-')
-			break;
-		if (argv[0][1] == 'D')
-			Dversion = T_strtod(argv[0] + 2, 0);
-		else if (argv[0][1] == 'C')
-			Dversion = 0;
-		else if (argv[0][1] == 'n')
-			demangleSymbols = false;
-		else if (argv[0][1] == 'e')
-			useTypedefEnum = true;
-		else if (argv[0][1] == 's' && argv[0][2])
-			dotReplacementChar = (char)argv[0][2];
-		else if (argv[0][1] == 'p' && argv[0][2])
-			pdbref = argv[0] + 2;
-		else
-			fatal("unknown option: " SARG, argv[0]);
-	}
-
-	if (argc < 2)
-	{
-		printf("Convert DMD CodeView/DWARF debug information to PDB files, Version %g\n", VERSION);
-		printf("Copyright (c) 2009-2012 by Rainer Schuetze, All Rights Reserved\n");
-		printf("\n");
-		printf("License for redistribution is given by the Artistic License 2.0\n");
-		printf("see file LICENSE for further details\n");
-		printf("\n");
-		printf("usage: " SARG " [-Dversion|-C|-n|-e|-sC|-pembedded-pdb] <exe-file> [new-exe-file] [pdb-file]\n", argv[0]);
-		return -1;
-	}
-
-	if (!img.load(argv[1]))
-		fatal(SARG ": %s", argv[1], img.getLastError());
-	if (img.countCVEntries() == 0 && !img.hasDWARF())
-		fatal(SARG ": no codeview debug entries found", argv[1]);
-
-	CV2PDB cv2pdb(img);
-	cv2pdb.Dversion = Dversion;
-	cv2pdb.initLibraries();
-
-	TCHAR* outname = argv[1];
-	if (argc > 2 && argv[2][0])
-		outname = argv[2];
-
-	TCHAR pdbname[260];
-	if (argc > 3)
-		T_strcpy (pdbname, argv[3]);
-	else
-	{
-		T_strcpy (pdbname, outname);
-		TCHAR *pDot = T_strrchr (pdbname, '.');
-		if (!pDot || pDot <= T_strrchr (pdbname, '/') || pDot <= T_strrchr (pdbname, '\\'))
-			T_strcat (pdbname, TEXT(".pdb"));
-		else
-			T_strcpy (pDot, TEXT(".pdb"));
-	}
-	makefullpath(pdbname);
-
-	T_unlink(pdbname);
-
-	if(!cv2pdb.openPDB(pdbname, pdbref))
-		fatal(SARG ": %s", pdbname, cv2pdb.getLastError());
-
-	if(img.hasDWARF())
-	{
-		if(!cv2pdb.relocateDebugLineInfo())
-			fatal(SARG ": %s", argv[1], cv2pdb.getLastError());
-
-		if(!cv2pdb.createDWARFModules())
-			fatal(SARG ": %s", pdbname, cv2pdb.getLastError());
-
-		if(!cv2pdb.addDWARFTypes())
-			fatal(SARG ": %s", pdbname, cv2pdb.getLastError());
-
-		if(!cv2pdb.addDWARFLines())
-			fatal(SARG ": %s", pdbname, cv2pdb.getLastError());
-
-		if (!cv2pdb.addDWARFPublics())
-			fatal(SARG ": %s", pdbname, cv2pdb.getLastError());
-
-		if (!cv2pdb.writeDWARFImage(outname))
-			fatal(SARG ": %s", outname, cv2pdb.getLastError());
-	}
-	else
-	{
-		if (!cv2pdb.initSegMap())
-			fatal(SARG ": %s", argv[1], cv2pdb.getLastError());
-
-		if (!cv2pdb.initGlobalSymbols())
-			fatal(SARG ": %s", argv[1], cv2pdb.getLastError());
-
-		if (!cv2pdb.initGlobalTypes())
-			fatal(SARG ": %s", argv[1], cv2pdb.getLastError());
-
-		if (!cv2pdb.createModules())
-			fatal(SARG ": %s", pdbname, cv2pdb.getLastError());
-
-		if (!cv2pdb.addTypes())
-			fatal(SARG ": %s", pdbname, cv2pdb.getLastError());
-
-		if (!cv2pdb.addSymbols())
-			fatal(SARG ": %s", pdbname, cv2pdb.getLastError());
-
-		if (!cv2pdb.addSrcLines())
-			fatal(SARG ": %s", pdbname, cv2pdb.getLastError());
-
-		if (!cv2pdb.addPublics())
-			fatal(SARG ": %s", pdbname, cv2pdb.getLastError());
-
-		if (!cv2pdb.writeImage(outname))
-			fatal(SARG ": %s", outname, cv2pdb.getLastError());
-	}
-
-	return 0;
-}
+// Convert DMD CodeView debug information to PDB files
+// Copyright (c) 2009-2010 by Rainer Schuetze, All Rights Reserved
+//
+// License for redistribution is given by the Artistic License 2.0
+// see file LICENSE for further details
+
+#include "convert.h"
+#include "stats.h"
+#include "cufilter.h"
+
+#include <direct.h>
+#include <io.h>
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+double
+#include "../VERSION"
+;
+
+#ifdef UNICODE
+#define T_toupper	towupper
+#define T_getdcwd	_wgetdcwd
+#define T_strlen	wcslen
+#define T_strcpy	wcscpy
+#define T_strcmp	wcscmp
+#define T_strcat	wcscat
+#define T_strstr	wcsstr
+#define T_strtod	wcstod
+#define T_strtoul	wcstoul
+#define T_strrchr	wcsrchr
+#define T_fopen		_wfopen
+#define T_fgets		fgetws
+#define T_fputs		fputws
+#define T_isspace	iswspace
+#define T_main		wmain
+#define SARG		"%S"
+#else
+#define T_toupper	toupper
+#define T_getdcwd	_getdcwd
+#define T_strlen	strlen
+#define T_strcpy	strcpy
+#define T_strcmp	strcmp
+#define T_strcat	strcat
+#define T_strstr	strstr
+#define T_strtod	strtod
+#define T_strtoul	strtoul
+#define T_strrchr	strrchr
+#define T_fopen		fopen
+#define T_fgets		fgets
+#define T_fputs		fputs
+#define T_isspace	isspace
+#define T_main		main
+#define SARG		"%s"
+#endif
+
+void fatal(const char *message, ...)
+{
+	va_list argptr;
+	va_start(argptr, message);
+	vprintf(message, argptr);
+	va_end(argptr);
+	printf("\n");
+	exit(1);
+}
+
+static char errorMessage[1024];
+
+// remember error message of the current conversion, always returns false
+bool failed(const char *message, ...)
+{
+	va_list argptr;
+	va_start(argptr, message);
+	vsnprintf(errorMessage, sizeof(errorMessage), message, argptr);
+	va_end(argptr);
+	errorMessage[sizeof(errorMessage) - 1] = 0; // not terminated by older CRTs if truncated
+	return false;
+}
+
+void makefullpath(TCHAR* pdbname)
+{
+	TCHAR* pdbstart = pdbname;
+	TCHAR fullname[260];
+	TCHAR* pfullname = fullname;
+
+	int drive = 0;
+	if (pdbname[0] && pdbname[1] == ':')
+	{
+		if (pdbname[2] == '\\' || pdbname[2] == '/')
+			return;
+		drive = T_toupper (pdbname[0]);
+		pdbname += 2;
+	}
+	else
+	{
+		drive = _getdrive();
+	}
+
+	if (*pdbname != '\\' && *pdbname != '/')
+	{
+		T_getdcwd(drive, pfullname, sizeof(fullname)/sizeof(fullname[0]) - 2);
+		pfullname += T_strlen(pfullname);
+		if (pfullname[-1] != '\\')
+			*pfullname++ = '\\';
+	}
+	else
+	{
+		*pfullname++ = 'a' - 1 + drive;
+		*pfullname++ = ':';
+	}
+	T_strcpy(pfullname, pdbname);
+	T_strcpy(pdbstart, fullname);
+
+	for(TCHAR*p = pdbstart; *p; p++)
+		if (*p == '/')
+			*p = '\\';
+
+	// remove relative parts "./" and "../"
+	while (TCHAR* p = T_strstr (pdbstart, TEXT("\\.\\")))
+		T_strcpy(p, p + 2);
+
+	while (TCHAR* p = T_strstr (pdbstart, TEXT("\\..\\")))
+	{
+		for (TCHAR* q = p - 1; q >= pdbstart; q--)
+			if (*q == '\\')
+			{
+				T_strcpy(q, p + 3);
+				break;
+			}
+	}
+}
+
+// conversion options shared by all images
+ConvertOptions options;
+CUFilter cuFilter;
+GUID signature;
+
+// options of the command line, each request of the conversion server starts with these
+ConvertOptions commandLineOptions;
+CUFilter commandLineCUFilter;
+GUID commandLineSignature;
+
+// report phase timings and counters after each conversion
+bool showStats = false;
+bool statsJson = false;
+
+void resetOptions()
+{
+	options = commandLineOptions;
+	cuFilter = commandLineCUFilter;
+	signature = commandLineSignature;
+	options.cuFilter = &cuFilter;
+	if (options.guid)
+		options.guid = &signature;
+}
+
+// names in the debug information are UTF-8
+static std::string toUTF8(const TCHAR* s)
+{
+#ifdef UNICODE
+	char buf[1024];
+	WideCharToMultiByte(CP_UTF8, 0, s, -1, buf, sizeof(buf), 0, 0);
+	return buf;
+#else
+	return s;
+#endif
+}
+
+// -a<address>[-<end-address>], hexadecimal virtual addresses
+static bool parseRange(const TCHAR* arg)
+{
+	TCHAR* end;
+	unsigned long lo = T_strtoul(arg, &end, 16);
+	if (end == arg)
+		return false;
+	unsigned long hi = lo + 1;
+	if (*end == '-')
+	{
+		const TCHAR* p = end + 1;
+		hi = T_strtoul(p, &end, 16);
+		if (end == p || hi <= lo)
+			return false;
+	}
+	if (*end)
+		return false;
+	cuFilter.addRange(lo, hi);
+	return true;
+}
+
+static unsigned long hexField(const char* hex, int len)
+{
+	char buf[9];
+	memcpy(buf, hex, len);
+	buf[len] = 0;
+	return strtoul(buf, 0, 16);
+}
+
+// -k<signature>, GUID and age as in symbol server paths: 32 hexadecimal digits
+// of the GUID followed by the age. Braces and dashes are ignored.
+static bool parseSignature(const TCHAR* arg)
+{
+	char hex[41];
+	int n = 0;
+	for (const TCHAR* p = arg; *p; p++)
+	{
+		if (*p == '{' || *p == '}' || *p == '-')
+			continue;
+		bool digit = (*p >= '0' && *p <= '9') || (*p >= 'a' && *p <= 'f') || (*p >= 'A' && *p <= 'F');
+		if (!digit || n >= 40)
+			return false;
+		hex[n++] = (char) *p;
+	}
+	if (n <= 32)
+		return false;
+
+	signature.Data1 = hexField(hex, 8);
+	signature.Data2 = (unsigned short) hexField(hex + 8, 4);
+	signature.Data3 = (unsigned short) hexField(hex + 12, 4);
+	for (int i = 0; i < 8; i++)
+		signature.Data4[i] = (unsigned char) hexField(hex + 16 + 2 * i, 2);
+	options.guid = &signature;
+	options.age = hexField(hex + 32, n - 32);
+	return true;
+}
+
+// returns false for unknown options
+bool parseOption(const TCHAR* opt)
+{
+	if (opt[1] == 'D')
+		options.Dversion = T_strtod(opt + 2, 0);
+	else if (opt[1] == 'C')
+		options.Dversion = 0;
+	else if (opt[1] == 'n')
+		options.demangleSymbols = false;
+	else if (opt[1] == 'e')
+		options.useTypedefEnum = true;
+	else if (opt[1] == 's' && opt[2])
+		options.dotReplacementChar = (char)opt[2];
+	else if (opt[1] == 'p' && opt[2])
+		options.pdbref = opt + 2;
+	else if (opt[1] == 'a' && opt[2])
+		return parseRange(opt + 2);
+	else if (opt[1] == 'u' && opt[2])
+		cuFilter.addUnitName(toUTF8(opt + 2).c_str());
+	else if (opt[1] == 'y' && opt[2])
+		cuFilter.addPublic(toUTF8(opt + 2).c_str());
+	else if (opt[1] == 'M' && opt[2])
+		options.memoryBudget = T_strtoul(opt + 2, 0, 10);
+	else if (opt[1] == 'l')
+		options.lineTablesOnly = true;
+	else if (opt[1] == 'k')
+	{
+		options.keepImage = true;
+		return !opt[2] || parseSignature(opt + 2);
+	}
+	else
+		return false;
+	return true;
+}
+
+// convert a single image, outname and pdbfile might be 0
+bool convertImage(const TCHAR* exename, const TCHAR* outname, const TCHAR* pdbfile)
+{
+	if (!outname || !outname[0])
+		outname = exename;
+
+	TCHAR pdbname[260];
+	if (pdbfile && pdbfile[0])
+		T_strcpy (pdbname, pdbfile);
+	else
+	{
+		T_strcpy (pdbname, outname);
+		TCHAR *pDot = T_strrchr (pdbname, '.');
+		if (!pDot || pDot <= T_strrchr (pdbname, '/') || pDot <= T_strrchr (pdbname, '\\'))
+			T_strcat (pdbname, TEXT(".pdb"));
+		else
+			T_strcpy (pDot, TEXT(".pdb"));
+	}
+	makefullpath(pdbname);
+
+	Converter converter(options);
+	if (!converter.convertFile(exename, outname, pdbname))
+		return failed("%s", converter.getLastError());
+	return true;
+}
+
+bool convert(const TCHAR* exename, const TCHAR* outname, const TCHAR* pdbfile)
+{
+	resetStats();
+	bool ok = STAT_PHASE("total", convertImage(exename, outname, pdbfile));
+	if (showStats)
+		printStats(statsJson);
+	return ok;
+}
+
+// split line into at most maxargs arguments separated by white space,
+// arguments containing spaces can be enclosed in double quotes
+int splitArgs(TCHAR* line, TCHAR* args[], int maxargs)
+{
+	int cnt = 0;
+	TCHAR* p = line;
+	for (;;)
+	{
+		while (*p && T_isspace(*p))
+			p++;
+		if (!*p || cnt >= maxargs)
+			break;
+
+		TCHAR* q = p;
+		args[cnt++] = q;
+		bool quoted = false;
+		for (; *p; p++)
+		{
+			if (*p == '"')
+				quoted = !quoted;
+			else if (!quoted && T_isspace(*p))
+				break;
+			else
+				*q++ = *p;
+		}
+		if (*p)
+			p++;
+		*q = 0;
+	}
+	return cnt;
+}
+
+typedef std::basic_string<TCHAR> tstring;
+
+// number of worker processes converting a batch, and the options passed on to them
+int jobs = 1;
+tstring workerOptions;
+
+// -r<result-file> is passed to worker processes: the result of each conversion is
+// written to this file as a line "1" or "0", and the worker prints no summary
+const TCHAR* resultfile = 0;
+
+struct BatchWorker
+{
+	TCHAR batchfile[MAX_PATH];
+	TCHAR resultfile[MAX_PATH];
+	HANDLE process;
+	HANDLE output;  // read end of the pipe connected to stdout of the worker
+	int items;      // images assigned to the worker
+	int converted;  // images reported as converted in the result file
+};
+
+static std::mutex outputMutex;
+
+// forward the output of a worker line by line, so that the lines of the workers
+// are not mixed up
+static void readWorkerOutput(BatchWorker* worker)
+{
+	std::string pending;
+	char buf[4096];
+	DWORD read;
+	while (ReadFile(worker->output, buf, sizeof(buf), &read, NULL) && read > 0)
+	{
+		pending.append(buf, read);
+		size_t eol;
+		while ((eol = pending.find('\n')) != std::string::npos)
+		{
+			std::string line = pending.substr(0, eol + 1);
+			pending.erase(0, eol + 1);
+
+			std::lock_guard<std::mutex> lock(outputMutex);
+			fputs(line.c_str(), stdout);
+		}
+	}
+	if (!pending.empty())
+	{
+		std::lock_guard<std::mutex> lock(outputMutex);
+		fputs(pending.c_str(), stdout);
+	}
+}
+
+// number of images reported as converted, a worker that crashed has not
+// reported the remaining images
+static int readWorkerResults(const TCHAR* resultfile)
+{
+	FILE* fh = T_fopen(resultfile, TEXT("r"));
+	if (!fh)
+		return 0;
+	int converted = 0;
+	char line[16];
+	while (fgets(line, sizeof(line), fh))
+		if (line[0] == '1')
+			converted++;
+	fclose(fh);
+	return converted;
+}
+
+static bool startWorker(BatchWorker& worker, const tstring& cmdline)
+{
+	SECURITY_ATTRIBUTES sa = { sizeof(sa), NULL, TRUE };
+	HANDLE writeEnd;
+	if (!CreatePipe(&worker.output, &writeEnd, &sa, 0))
+		return false;
+	SetHandleInformation(worker.output, HANDLE_FLAG_INHERIT, 0);
+
+	STARTUPINFO si;
+	memset(&si, 0, sizeof(si));
+	si.cb = sizeof(si);
+	si.dwFlags = STARTF_USESTDHANDLES;
+	si.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+	si.hStdOutput = writeEnd;
+	si.hStdError = GetStdHandle(STD_ERROR_HANDLE);
+
+	PROCESS_INFORMATION pi;
+	std::vector<TCHAR> cmd(cmdline.begin(), cmdline.end());
+	cmd.push_back(0);
+	BOOL started = CreateProcess(NULL, &cmd[0], NULL, NULL, TRUE, 0, NULL, NULL, &si, &pi);
+	CloseHandle(writeEnd);
+	if (!started)
+	{
+		CloseHandle(worker.output);
+		worker.output = 0;
+		return false;
+	}
+	CloseHandle(pi.hThread);
+	worker.process = pi.hProcess;
+	return true;
+}
+
+// distribute the images round-robin to worker processes, each converting its
+// share as a batch of its own. The PDB helper DLL and the converter are not
+// safe to use from multiple threads, so parallel conversions need processes.
+int convertParallel(const std::vector<tstring>& items)
+{
+	TCHAR exe[MAX_PATH], tmpdir[MAX_PATH];
+	if (!GetModuleFileName(NULL, exe, MAX_PATH) || !GetTempPath(MAX_PATH, tmpdir))
+		fatal("cannot start worker processes");
+
+	size_t cnt = (size_t) jobs < items.size() ? jobs : items.size();
+	std::vector<BatchWorker> workers(cnt);
+	for (size_t w = 0; w < cnt; w++)
+	{
+		BatchWorker& worker = workers[w];
+		memset(&worker, 0, sizeof(worker));
+		if (!GetTempFileName(tmpdir, TEXT("cvb"), 0, worker.batchfile) ||
+		    !GetTempFileName(tmpdir, TEXT("cvr"), 0, worker.resultfile))
+			fatal("cannot create temporary batch file");
+		FILE* fh = T_fopen(worker.batchfile, TEXT("w"));
+		if (!fh)
+			fatal(SARG ": cannot create batch file", worker.batchfile);
+		for (size_t i = w; i < items.size(); i += cnt)
+		{
+			T_fputs(items[i].c_str(), fh);
+			T_fputs(TEXT("\n"), fh);
+			worker.items++;
+		}
+		fclose(fh);
+
+		tstring cmdline = TEXT("\"") + tstring(exe) + TEXT("\"") + workerOptions;
+		cmdline += TEXT(" \"-r") + tstring(worker.resultfile) + TEXT("\"");
+		cmdline += TEXT(" \"-b") + tstring(worker.batchfile) + TEXT("\"");
+		if (!startWorker(worker, cmdline))
+			printf("error: cannot start worker process\n");
+	}
+
+	std::vector<std::thread> readers;
+	for (size_t w = 0; w < cnt; w++)
+		if (workers[w].output)
+			readers.push_back(std::thread(readWorkerOutput, &workers[w]));
+	for (size_t r = 0; r < readers.size(); r++)
+		readers[r].join();
+
+	// images not reported by a worker that could not start or crashed count as failures
+	int converted = 0, failures = 0;
+	for (size_t w = 0; w < cnt; w++)
+	{
+		BatchWorker& worker = workers[w];
+		if (worker.process)
+		{
+			WaitForSingleObject(worker.process, INFINITE);
+			CloseHandle(worker.process);
+		}
+		if (worker.output)
+			CloseHandle(worker.output);
+		worker.converted = worker.process ? readWorkerResults(worker.resultfile) : 0;
+		DeleteFile(worker.batchfile);
+		DeleteFile(worker.resultfile);
+		converted += worker.converted;
+		failures += worker.items - worker.converted;
+	}
+	printf("%d of %d images converted\n", converted, converted + failures);
+	return failures ? 1 : 0;
+}
+
+// each line of the batch file holds the arguments <exe-file> [new-exe-file] [pdb-file]
+// returns 0 if all images are converted, 1 otherwise
+int convertBatch(const TCHAR* batchfile)
+{
+	FILE* fh = T_fopen(batchfile, TEXT("r"));
+	if (!fh)
+		fatal(SARG ": cannot open batch file", batchfile);
+
+	std::vector<tstring> items;
+	TCHAR line[1024];
+	while (T_fgets(line, sizeof(line)/sizeof(line[0]), fh))
+	{
+		TCHAR* p = line;
+		while (*p && T_isspace(*p))
+			p++;
+		if (!*p || *p == '#')
+			continue;
+		size_t len = T_strlen(p);
+		while (len > 0 && T_isspace(p[len - 1]))
+			p[--len] = 0;
+		items.push_back(p);
+	}
+	fclose(fh);
+
+	if (jobs > 1 && items.size() > 1)
+		return convertParallel(items);
+
+	FILE* rh = 0;
+	if (resultfile && !(rh = T_fopen(resultfile, TEXT("w"))))
+		fatal(SARG ": cannot create result file", resultfile);
+
+	int converted = 0, failures = 0;
+	for (size_t i = 0; i < items.size(); i++)
+	{
+		T_strcpy(line, items[i].c_str());
+		TCHAR* args[3] = { 0, 0, 0 };
+		splitArgs(line, args, 3);
+
+		bool ok = convert(args[0], args[1], args[2]);
+		if (ok)
+		{
+			printf("ok: " SARG "\n", args[0]);
+			converted++;
+		}
+		else
+		{
+			printf("error: %s\n", errorMessage);
+			failures++;
+		}
+		fflush(stdout);
+		if (rh)
+		{
+			fputs(ok ? "1\n" : "0\n", rh);
+			fflush(rh);
+		}
+	}
+
+	if (rh)
+		fclose(rh);
+	else
+		printf("%d of %d images converted\n", converted, converted + failures);
+	return failures ? 1 : 0;
+}
+
+// execute a request of the conversion server, the request has the same
+// options and file arguments as the command line
+bool convertRequest(TCHAR* request)
+{
+	TCHAR* args[32];
+	int cnt = splitArgs(request, args, 32);
+
+	resetOptions();
+	int a = 0;
+	for (; a < cnt && args[a][0] == '-'; a++)
+		if (!parseOption(args[a]))
+			return failed("unknown option: " SARG, args[a]);
+	if (a >= cnt)
+		return failed("missing file name");
+	if (cnt - a > 3)
+		return failed("too many arguments");
+
+	return convert(args[a], a + 1 < cnt ? args[a + 1] : 0, a + 2 < cnt ? args[a + 2] : 0);
+}
+
+// answer every request with "ok <milliseconds>" or "error <milliseconds> <message>"
+// returns false if the server should shut down
+bool serveClient(HANDLE pipe)
+{
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+
+	char buf[4096];
+	DWORD len = 0, read;
+	while (ReadFile(pipe, buf + len, sizeof(buf) - 1 - len, &read, NULL) && read > 0)
+	{
+		len += read;
+		buf[len] = 0;
+
+		char* eol;
+		while ((eol = strchr(buf, '\n')) != 0)
+		{
+			*eol = 0;
+			if (eol > buf && eol[-1] == '\r')
+				eol[-1] = 0;
+			if (strcmp(buf, "quit") == 0)
+				return false;
+
+			TCHAR request[sizeof(buf)];
+#ifdef UNICODE
+			MultiByteToWideChar(CP_UTF8, 0, buf, -1, request, sizeof(buf));
+#else
+			strcpy(request, buf);
+#endif
+			LARGE_INTEGER start, stop;
+			QueryPerformanceCounter(&start);
+			bool ok = convertRequest(request);
+			QueryPerformanceCounter(&stop);
+			double ms = (stop.QuadPart - start.QuadPart) * 1000.0 / freq.QuadPart;
+
+			char reply[sizeof(errorMessage) + 64];
+			if (ok)
+				sprintf(reply, "ok %.3f\n", ms);
+			else
+				sprintf(reply, "error %.3f %s\n", ms, errorMessage);
+			DWORD written;
+			if (!WriteFile(pipe, reply, strlen(reply), &written, NULL))
+				return true;
+
+			len -= eol + 1 - buf;
+			memmove(buf, eol + 1, len + 1);
+		}
+		if (len >= sizeof(buf) - 1)
+			len = 0; // drop overlong request
+	}
+	return true;
+}
+
+// stay resident and convert images on requests received through a named pipe
+int serve(const TCHAR* name)
+{
+	TCHAR pipename[260];
+	T_strcpy(pipename, TEXT("\\\\.\\pipe\\"));
+	if (T_strstr(name, pipename) == name)
+		pipename[0] = 0;
+	T_strcat(pipename, name);
+
+	for (;;)
+	{
+		HANDLE pipe = CreateNamedPipe(pipename, PIPE_ACCESS_DUPLEX, PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT,
+		                              1, 4096, 4096, 0, NULL);
+		if (pipe == INVALID_HANDLE_VALUE)
+			fatal(SARG ": cannot create named pipe", pipename);
+
+		bool quit = false;
+		if (ConnectNamedPipe(pipe, NULL) || GetLastError() == ERROR_PIPE_CONNECTED)
+			quit = !serveClient(pipe);
+
+		FlushFileBuffers(pipe);
+		DisconnectNamedPipe(pipe);
+		CloseHandle(pipe);
+		if (quit)
+			break;
+	}
+	return 0;
+}
+
+int T_main(int argc, TCHAR* argv[])
+{
+	const TCHAR* batchfile = 0;
+	const TCHAR* pipename = 0;
+
+	resetOptions();
+	while (argc > 1 && argv[1][0] == '-')
+	{
+		argv++;
+		argc--;
+		if (T_strcmp(argv[0], TEXT("--stats")) == 0)
+			showStats = true;
+		else if (T_strcmp(argv[0], TEXT("--stats=json")) == 0)
+			showStats = statsJson = true;
+		else if (argv[0][1] == '-')
+			break;
+		else if (argv[0][1] == 'b' && argv[0][2])
+			batchfile = argv[0] + 2;
+		else if (argv[0][1] == 'S' && argv[0][2])
+			pipename = argv[0] + 2;
+		else if (argv[0][1] == 'j' && argv[0][2])
+			jobs = T_strtoul(argv[0] + 2, 0, 10);
+		else if (argv[0][1] == 'r' && argv[0][2])
+			resultfile = argv[0] + 2;
+		else if (!parseOption(argv[0]))
+			fatal("unknown option: " SARG, argv[0]);
+
+		// options other than -b, -S, -j and -r are passed on to worker processes
+		if (argv[0][1] != 'b' && argv[0][1] != 'S' && argv[0][1] != 'j' && argv[0][1] != 'r')
+			workerOptions += TEXT(" \"") + tstring(argv[0]) + TEXT("\"");
+	}
+
+	commandLineOptions = options;
+	commandLineCUFilter = cuFilter;
+	commandLineSignature = signature;
+
+	if (batchfile)
+		return convertBatch(batchfile);
+	if (pipename)
+		return serve(pipename);
+
+	if (argc < 2)
+	{
+		printf("Convert DMD CodeView/DWARF debug information to PDB files, Version %g\n", VERSION);
+		printf("Copyright (c) 2009-2012 by Rainer Schuetze, All Rights Reserved\n");
+		printf("\n");
+		printf("License for redistribution is given by the Artistic License 2.0\n");
+		printf("see file LICENSE for further details\n");
+		printf("\n");
+		printf("usage: " SARG " [-Dversion|-C|-n|-e|-sC|-pembedded-pdb|-aA[-E]|-uU|-yS|-Mmegabytes|-l|-k[signature]|--stats[=json]] <exe-file> [new-exe-file] [pdb-file]\n", argv[0]);
+		printf("       " SARG " [options] [-jworkers] -b<batch-file>\n", argv[0]);
+		printf("       " SARG " [options] -S<pipe-name>\n", argv[0]);
+		return -1;
+	}
+
+	if (!convert(argv[1], argc > 2 ? argv[2] : 0, argc > 3 ? argv[3] : 0))
+		fatal("%s", errorMessage);
+
+	return 0;
+}
@@ -0,0 +1,182 @@
+// Convert DMD CodeView/DWARF debug information to PDB files
+// Copyright (c) 2009-2012 by Rainer Schuetze, All Rights Reserved
+//
+// License for redistribution is given by the Artistic License 2.0
+// see file LICENSE for further details
+
+#ifndef _WIN32
+#define _FILE_OFFSET_BITS 64 // 64-bit file offsets on 32-bit systems
+#endif
+
+#include "pdbfile.h"
+
+#include <string.h>
+
+#ifdef _WIN32
+#define fseek64		_fseeki64
+#else
+#define fseek64		fseeko
+#endif
+
+#ifdef UNICODE
+#define T_fopen	_wfopen
+#else
+#define T_fopen	fopen
+#endif
+
+static const char kMSFMagic[] = "Microsoft C/C++ MSF 7.00\r\n\x1a" "DS\0\0"; // 32 bytes
+
+static const unsigned int kStreamPDB = 1;
+static const unsigned int kStreamDBI = 3;
+
+struct MSFSuperBlock
+{
+	char magic[32];
+	unsigned int blockSize;
+	unsigned int freeBlockMap;
+	unsigned int numBlocks;
+	unsigned int numDirectoryBytes;
+	unsigned int unknown;
+	unsigned int blockMapAddr; // first block listing the blocks of the stream directory, more follow
+	                           // if the directory has more than blockSize / 4 blocks
+};
+
+struct PDBStreamHeader
+{
+	unsigned int version;
+	unsigned int signature; // time stamp
+	unsigned int age;
+	GUID guid;
+};
+
+struct DBIStreamHeader
+{
+	unsigned int versionSignature; // -1
+	unsigned int version;
+	unsigned int age;
+};
+
+PDBFile::PDBFile()
+: fh(0)
+, blockSize(0)
+, numBlocks(0)
+{
+}
+
+bool PDBFile::setSignature(const TCHAR* fname, const GUID& guid, unsigned long age)
+{
+	fh = T_fopen(fname, TEXT("r+b"));
+	if (!fh)
+		return setError("cannot open PDB file");
+
+	bool ok = patchSignature(guid, age);
+	if (fclose(fh) != 0 && ok)
+		ok = setError("cannot write PDB file");
+	fh = 0;
+	return ok;
+}
+
+bool PDBFile::patchSignature(const GUID& guid, unsigned long age)
+{
+	if (!readDirectory())
+		return false;
+
+	PDBStreamHeader pdbHeader;
+	unsigned long long off = streamOffset(kStreamPDB, sizeof(pdbHeader));
+	if (!off)
+		return setError("PDB stream not found");
+	if (!read(off, &pdbHeader, sizeof(pdbHeader)))
+		return false;
+	pdbHeader.age = age;
+	pdbHeader.guid = guid;
+	if (!write(off, &pdbHeader, sizeof(pdbHeader)))
+		return false;
+
+	// debuggers also compare the age stored with the DBI stream
+	DBIStreamHeader dbiHeader;
+	off = streamOffset(kStreamDBI, sizeof(dbiHeader));
+	if (!off)
+		return setError("DBI stream not found");
+	if (!read(off, &dbiHeader, sizeof(dbiHeader)))
+		return false;
+	if (dbiHeader.versionSignature != 0xffffffff)
+		return setError("unknown DBI stream version");
+	dbiHeader.age = age;
+	return write(off, &dbiHeader, sizeof(dbiHeader));
+}
+
+bool PDBFile::readDirectory()
+{
+	MSFSuperBlock sb;
+	if (!read(0, &sb, sizeof(sb)) || memcmp(sb.magic, kMSFMagic, sizeof(kMSFMagic)) != 0)
+		return setError("PDB file not in MSF 7.00 format");
+	if (sb.blockSize < 512 || (sb.blockSize & (sb.blockSize - 1)) != 0 || sb.numDirectoryBytes < 4)
+		return setError("invalid MSF super block");
+	blockSize = sb.blockSize;
+	numBlocks = sb.numBlocks;
+
+	unsigned int dirBlocks = (sb.numDirectoryBytes + blockSize - 1) / blockSize;
+	unsigned int mapBlocks = (dirBlocks + blockSize / 4 - 1) / (blockSize / 4);
+	if (sizeof(sb) + (mapBlocks - 1) * 4 > blockSize)
+		return setError("invalid MSF block map");
+	std::vector<unsigned int> mapAddrs(mapBlocks);
+	if (!read(sizeof(sb) - 4, &mapAddrs[0], mapBlocks * 4))
+		return false;
+	std::vector<unsigned int> blockMap(mapBlocks * (blockSize / 4));
+	for (unsigned int m = 0; m < mapBlocks; m++)
+	{
+		if (mapAddrs[m] >= numBlocks)
+			return setError("invalid MSF block map");
+		if (!read((unsigned long long) mapAddrs[m] * blockSize, &blockMap[m * (blockSize / 4)], blockSize))
+			return false;
+	}
+
+	directory.resize(dirBlocks * (blockSize / 4));
+	for (unsigned int b = 0; b < dirBlocks; b++)
+	{
+		if (blockMap[b] >= numBlocks)
+			return setError("invalid MSF block map");
+		if (!read((unsigned long long) blockMap[b] * blockSize, &directory[b * (blockSize / 4)], blockSize))
+			return false;
+	}
+	directory.resize(sb.numDirectoryBytes / 4);
+	if (directory[0] >= directory.size())
+		return setError("invalid MSF stream directory");
+	return true;
+}
+
+unsigned long long PDBFile::streamOffset(unsigned int stream, unsigned int len)
+{
+	unsigned int numStreams = directory[0];
+	if (stream >= numStreams)
+		return 0;
+
+	// the block lists follow the sizes of all streams, deleted streams have size -1
+	size_t pos = 1 + numStreams;
+	for (unsigned int s = 0; s < stream; s++)
+	{
+		unsigned int size = directory[1 + s];
+		if (size != 0xffffffff)
+			pos += (size + blockSize - 1) / blockSize;
+	}
+	unsigned int size = directory[1 + stream];
+	if (size == 0xffffffff || size < len || pos >= directory.size())
+		return 0;
+	if (directory[pos] == 0 || directory[pos] >= numBlocks)
+		return 0;
+	return (unsigned long long) directory[pos] * blockSize;
+}
+
+bool PDBFile::read(unsigned long long off, void* data, unsigned int len)
+{
+	if (fseek64(fh, off, SEEK_SET) != 0 || fread(data, 1, len, fh) != len)
+		return setError("cannot read PDB file");
+	return true;
+}
+
+bool PDBFile::write(unsigned long long off, const void* data, unsigned int len)
+{
+	if (fseek64(fh, off, SEEK_SET) != 0 || fwrite(data, 1, len, fh) != len)
+		return setError("cannot write PDB file");
+	return true;
+}
@@ -0,0 +1,41 @@
+// Convert DMD CodeView/DWARF debug information to PDB files
+// Copyright (c) 2009-2012 by Rainer Schuetze, All Rights Reserved
+//
+// License for redistribution is given by the Artistic License 2.0
+// see file LICENSE for further details
+
+#ifndef __PDBFILE_H__
+#define __PDBFILE_H__
+
+#include "LastError.h"
+
+#include "pecoff.h"
+#include <stdio.h>
+#include <vector>
+
+// direct access to a PDB file (MSF 7.00) after it has been closed by the
+// PDB helper DLL. The DLL always creates a new signature, so to match the
+// RSDS record of an image that is not rewritten the signature is replaced.
+class PDBFile : public LastError
+{
+public:
+	PDBFile();
+
+	// set GUID and age of the PDB stream and the age of the DBI stream
+	bool setSignature(const TCHAR* fname, const GUID& guid, unsigned long age);
+
+private:
+	bool patchSignature(const GUID& guid, unsigned long age);
+	bool readDirectory();
+	unsigned long long streamOffset(unsigned int stream, unsigned int len); // first block of the stream
+
+	bool read(unsigned long long off, void* data, unsigned int len);
+	bool write(unsigned long long off, const void* data, unsigned int len);
+
+	FILE* fh;
+	unsigned int blockSize;
+	unsigned int numBlocks;
+	std::vector<unsigned int> directory; // stream count, stream sizes, block lists
+};
+
+#endif //__PDBFILE_H__
@@ -1,519 +1,1209 @@
-#include "readDwarf.h"
-#include <assert.h>
-#include <unordered_map>
-#include <array>
-#include <windows.h>
-
-#include "PEImage.h"
-#include "dwarf.h"
-#include "mspdb.h"
-extern "C" {
-	#include "mscvpdb.h"
-}
-
-static Location mkInReg(unsigned reg)
-{
-	Location l;
-	l.type = Location::InReg;
-	l.reg = reg;
-	return l;
-}
-
-static Location mkAbs(int off)
-{
-	Location l;
-	l.type = Location::Abs;
-	l.off = off;
-	return l;
-}
-
-static Location mkRegRel(int reg, int off)
-{
-	Location l;
-	l.type = Location::RegRel;
-	l.reg = reg;
-	l.off = off;
-	return l;
-}
-
-Location decodeLocation(const DWARF_Attribute& attr, const Location* frameBase)
-{
-	static Location invalid = { Location::Invalid };
-
-	if (attr.type == Const)
-		return mkAbs(attr.cons);
-
-	if (attr.type != ExprLoc)
-		return invalid;
-
-	byte* p = attr.expr.ptr;
-	Location stack[256];
-	int stackDepth = 0;
-
-	for (;;)
-	{
-		if (p >= attr.expr.ptr + attr.expr.len)
-			break;
-
-		int op = *p++;
-		if (op == 0)
-			break;
-
-		switch (op)
-		{
-			case DW_OP_reg0:  case DW_OP_reg1:  case DW_OP_reg2:  case DW_OP_reg3:
-			case DW_OP_reg4:  case DW_OP_reg5:  case DW_OP_reg6:  case DW_OP_reg7:
-			case DW_OP_reg8:  case DW_OP_reg9:  case DW_OP_reg10: case DW_OP_reg11:
-			case DW_OP_reg12: case DW_OP_reg13: case DW_OP_reg14: case DW_OP_reg15:
-			case DW_OP_reg16: case DW_OP_reg17: case DW_OP_reg18: case DW_OP_reg19:
-			case DW_OP_reg20: case DW_OP_reg21: case DW_OP_reg22: case DW_OP_reg23:
-			case DW_OP_reg24: case DW_OP_reg25: case DW_OP_reg26: case DW_OP_reg27:
-			case DW_OP_reg28: case DW_OP_reg29: case DW_OP_reg30: case DW_OP_reg31:
-				stack[stackDepth++] = mkInReg(op - DW_OP_reg0);
-				break;
-			case DW_OP_regx:
-				stack[stackDepth++] = mkInReg(LEB128(p));
-				break;
-
-			case DW_OP_const1u: stack[stackDepth++] = mkAbs(*p); break;
-			case DW_OP_const2u: stack[stackDepth++] = mkAbs(RD2(p)); break;
-			case DW_OP_const4u: stack[stackDepth++] = mkAbs(RD4(p)); break;
-			case DW_OP_const1s: stack[stackDepth++] = mkAbs((char)*p); break;
-			case DW_OP_const2s: stack[stackDepth++] = mkAbs((short)RD2(p)); break;
-			case DW_OP_const4s: stack[stackDepth++] = mkAbs((int)RD4(p)); break;
-			case DW_OP_constu:  stack[stackDepth++] = mkAbs(LEB128(p)); break;
-			case DW_OP_consts:  stack[stackDepth++] = mkAbs(SLEB128(p)); break;
-
-			case DW_OP_plus_uconst: 
-				if (stack[stackDepth - 1].is_inreg())
-					return invalid;
-				stack[stackDepth - 1].off += LEB128(p); 
-				break;
-
-			case DW_OP_lit0:  case DW_OP_lit1:  case DW_OP_lit2:  case DW_OP_lit3:
-			case DW_OP_lit4:  case DW_OP_lit5:  case DW_OP_lit6:  case DW_OP_lit7:
-			case DW_OP_lit8:  case DW_OP_lit9:  case DW_OP_lit10: case DW_OP_lit11:
-			case DW_OP_lit12: case DW_OP_lit13: case DW_OP_lit14: case DW_OP_lit15:
-			case DW_OP_lit16: case DW_OP_lit17: case DW_OP_lit18: case DW_OP_lit19:
-			case DW_OP_lit20: case DW_OP_lit21: case DW_OP_lit22: case DW_OP_lit23:
-				stack[stackDepth++] = mkAbs(op - DW_OP_lit0);
-				break;
-
-			case DW_OP_breg0:  case DW_OP_breg1:  case DW_OP_breg2:  case DW_OP_breg3:
-			case DW_OP_breg4:  case DW_OP_breg5:  case DW_OP_breg6:  case DW_OP_breg7:
-			case DW_OP_breg8:  case DW_OP_breg9:  case DW_OP_breg10: case DW_OP_breg11:
-			case DW_OP_breg12: case DW_OP_breg13: case DW_OP_breg14: case DW_OP_breg15:
-			case DW_OP_breg16: case DW_OP_breg17: case DW_OP_breg18: case DW_OP_breg19:
-			case DW_OP_breg20: case DW_OP_breg21: case DW_OP_breg22: case DW_OP_breg23:
-			case DW_OP_breg24: case DW_OP_breg25: case DW_OP_breg26: case DW_OP_breg27:
-			case DW_OP_breg28: case DW_OP_breg29: case DW_OP_breg30: case DW_OP_breg31:
-				stack[stackDepth++] = mkRegRel(op - DW_OP_breg0, SLEB128(p));
-				break;
-			case DW_OP_bregx:
-			{
-				unsigned reg = LEB128(p);
-				stack[stackDepth++] = mkRegRel(reg, SLEB128(p));
-			}   break;
-
-
-			case DW_OP_abs: case DW_OP_neg: case DW_OP_not:
-			{
-				Location& op1 = stack[stackDepth - 1];
-				if (!op1.is_abs())
-					return invalid;
-				switch (op)
-				{
-					case DW_OP_abs:   op1 = mkAbs(abs(op1.off)); break;
-					case DW_OP_neg:   op1 = mkAbs(-op1.off); break;
-					case DW_OP_not:   op1 = mkAbs(~op1.off); break;
-				}
-			}   break;
-
-			case DW_OP_plus:  // op2 + op1
-			{
-				Location& op1 = stack[stackDepth - 1];
-				Location& op2 = stack[stackDepth - 2];
-				// Can add only two offsets or a regrel and an offset.
-				if (op2.is_regrel() && op1.is_abs())
-					op2 = mkRegRel(op2.reg, op2.off + op1.off);
-				else if (op2.is_abs() && op1.is_regrel())
-					op2 = mkRegRel(op1.reg, op2.off + op1.off);
-				else if (op2.is_abs() && op1.is_abs())
-					op2 = mkAbs(op2.off + op1.off);
-				else
-					return invalid;
-				--stackDepth;
-			}   break;
-
-			case DW_OP_minus: // op2 - op1
-			{
-				Location& op1 = stack[stackDepth - 1];
-				Location& op2 = stack[stackDepth - 2];
-				if (op2.is_regrel() && op1.is_regrel() && op2.reg == op1.reg)
-					op2 = mkAbs(0); // X - X == 0
-				else if (op2.is_regrel() && op1.is_abs())
-					op2 = mkRegRel(op2.reg, op2.off - op1.off);
-				else if (op2.is_abs() && op1.is_abs())
-					op2 = mkAbs(op2.off - op1.off);
-				else
-					return invalid;
-				--stackDepth;
-			}   break;
-
-			case DW_OP_mul:
-			{
-				Location& op1 = stack[stackDepth - 1];
-				Location& op2 = stack[stackDepth - 2];
-				if ((op1.is_abs() && op1.off == 0) || (op2.is_abs() && op2.off == 0))
-					op2 = mkAbs(0); // X * 0 == 0
-				else if (op1.is_abs() && op2.is_abs())
-					op2 = mkAbs(op1.off * op2.off);
-				else
-					return invalid;
-				--stackDepth;
-			}   break;
-
-			case DW_OP_and:
-			{
-				Location& op1 = stack[stackDepth - 1];
-				Location& op2 = stack[stackDepth - 2];
-				if ((op1.is_abs() && op1.off == 0) || (op2.is_abs() && op2.off == 0))
-					op2 = mkAbs(0); // X & 0 == 0
-				else if (op1.is_abs() && op2.is_abs())
-					op2 = mkAbs(op1.off & op2.off);
-				else
-					return invalid;
-				--stackDepth;
-			}   break;
-
-			case DW_OP_div: case DW_OP_mod: case DW_OP_shl:
-			case DW_OP_shr: case DW_OP_shra: case DW_OP_or:
-			case DW_OP_xor:
-			case DW_OP_eq:  case DW_OP_ge:  case DW_OP_gt:
-			case DW_OP_le:  case DW_OP_lt:  case DW_OP_ne:
-			{
-				Location& op1 = stack[stackDepth - 1];
-				Location& op2 = stack[stackDepth - 2];
-				if (!op1.is_abs() || !op2.is_abs()) // can't combine unless both are constants
-					return invalid;
-				switch (op)
-				{
-					case DW_OP_div:   op2.off = op2.off / op1.off; break;
-					case DW_OP_mod:   op2.off = op2.off % op1.off; break;
-					case DW_OP_shl:   op2.off = op2.off << op1.off; break;
-					case DW_OP_shr:   op2.off = op2.off >> op1.off; break;
-					case DW_OP_shra:  op2.off = op2.off >> op1.off; break;
-					case DW_OP_or:    op2.off = op2.off | op1.off; break;
-					case DW_OP_xor:   op2.off = op2.off ^ op1.off; break;
-					case DW_OP_eq:    op2.off = op2.off == op1.off; break;
-					case DW_OP_ge:    op2.off = op2.off >= op1.off; break;
-					case DW_OP_gt:    op2.off = op2.off > op1.off; break;
-					case DW_OP_le:    op2.off = op2.off <= op1.off; break;
-					case DW_OP_lt:    op2.off = op2.off < op1.off; break;
-					case DW_OP_ne:    op2.off = op2.off != op1.off; break;
-				}
-				--stackDepth;
-			}   break;
-
-			case DW_OP_fbreg:
-			{
-				if (!frameBase)
-					return invalid;
-
-				Location loc;
-				if (frameBase->is_inreg()) // ok in frame base specification, per DWARF4 spec #3.3.5
-					loc = mkRegRel(frameBase->reg, SLEB128(p));
-				else if (frameBase->is_regrel())
-					loc = mkRegRel(frameBase->reg, frameBase->off + SLEB128(p));
-				else
-					return invalid;
-				stack[stackDepth++] = loc;
-			}   break;
-
-			case DW_OP_dup:   stack[stackDepth] = stack[stackDepth - 1]; stackDepth++; break;
-			case DW_OP_drop:  stackDepth--; break;
-			case DW_OP_over:  stack[stackDepth] = stack[stackDepth - 2]; stackDepth++; break;
-			case DW_OP_pick:  stack[stackDepth++] = stack[*p]; break;
-			case DW_OP_swap:  { Location tmp = stack[stackDepth - 1]; stack[stackDepth - 1] = stack[stackDepth - 2]; stack[stackDepth - 2] = tmp; } break;
-			case DW_OP_rot:   { Location tmp = stack[stackDepth - 1]; stack[stackDepth - 1] = stack[stackDepth - 2]; stack[stackDepth - 2] = stack[stackDepth - 3]; stack[stackDepth - 3] = tmp; } break;
-
-			case DW_OP_addr:
-				stack[stackDepth++] = mkAbs(RD4(p)); // TODO: 64-bit
-				break;
-
-			case DW_OP_skip:
-			{
-				unsigned off = RD2(p);
-				p = p + off;
-			}   break;
-
-			case DW_OP_bra:
-			{
-				Location& op1 = stack[stackDepth - 1];
-				if (!op1.is_abs())
-					return invalid;
-				if (op1.off != 0)
-				{
-					unsigned off = RD2(p);
-					p = p + off;
-				}
-				--stackDepth;
-			}   break;
-
-			case DW_OP_nop:
-				break;
-
-			case DW_OP_deref:
-			case DW_OP_deref_size:
-			case DW_OP_push_object_address:
-			case DW_OP_call2:
-			case DW_OP_call4:
-			case DW_OP_form_tls_address:
-			case DW_OP_call_frame_cfa:
-			case DW_OP_call_ref:
-			case DW_OP_bit_piece:
-			case DW_OP_implicit_value:
-			case DW_OP_stack_value:
-			default:
-				return invalid;
-		}
-	}
-
-	assert(stackDepth > 0);
-	return stack[0];
-}
-
-// declare hasher for pair<T1,T2>
-namespace std
-{
-	template<typename T1, typename T2>
-	struct hash<std::pair<T1, T2>>
-	{
-		size_t operator()(const std::pair<T1, T2>& t)
-		{
-			return std::hash<T1>()(t.first) ^ std::hash<T2>()(t.second);
-		}
-	};
-}
-
-typedef std::unordered_map<std::pair<unsigned, unsigned>, byte*> abbrevMap_t;
-
-static PEImage* img;
-static abbrevMap_t abbrevMap;
-
-void DIECursor::setContext(PEImage* img_)
-{
-	img = img_;
-	abbrevMap.clear();
-}
-
-
-DIECursor::DIECursor(DWARF_CompilationUnit* cu_, byte* ptr_)
-{
-	cu = cu_;
-	ptr = ptr_;
-	level = 0;
-	hasChild = false;
-	sibling = 0;
-}
-
-
-bool DIECursor::readSibling(DWARF_InfoData& id)
-{
-	if (sibling)
-	{
-		// use sibling pointer, if available
-		ptr = sibling;
-		hasChild = false;
-	} 
-	else if (hasChild)
-	{
-		int currLevel = level;
-		level = currLevel + 1;
-		hasChild = false;
-
-		DWARF_InfoData dummy;
-		// read untill we pop back to the level we were at
-		while (level > currLevel)
-			readNext(dummy);
-	}
-
-	return readNext(id, true);
-}
-
-DIECursor DIECursor::getSubtreeCursor()
-{
-	if (hasChild)
-	{
-		DIECursor subtree = *this;
-		subtree.level = 0;
-		subtree.hasChild = false;
-		return subtree;
-	}
-	else // Return invalid cursor
-	{
-		DIECursor subtree = *this;
-		subtree.level = -1;
-		return subtree;
-	}
-}
-
-bool DIECursor::readNext(DWARF_InfoData& id, bool stopAtNull)
-{
-	id.clear();
-
-	if (hasChild)
-		++level;
-
-	for (;;)
-	{
-		if (level == -1)
-			return false; // we were already at the end of the subtree
-
-		if (ptr >= ((byte*)cu + sizeof(cu->unit_length) + cu->unit_length))
-			return false; // root of the tree does not have a null terminator, but we know the length
-
-		id.entryPtr = ptr;
-		id.entryOff = ptr - (byte*)cu;
-		id.code = LEB128(ptr);
-		if (id.code == 0)
-		{
-			--level; // pop up one level
-			if (stopAtNull)
-			{
-				hasChild = false;
-				return false;
-			}
-			continue; // read the next DIE
-		}
-
-		break;
-	}
-
-	byte* abbrev = getDWARFAbbrev(cu->debug_abbrev_offset, id.code);
-	assert(abbrev);
-	if (!abbrev)
-		return false;
-
-	id.abbrev = abbrev;
-	id.tag = LEB128(abbrev);
-	id.hasChild = *abbrev++;
-
-	int attr, form;
-	for (;;)
-	{
-		attr = LEB128(abbrev);
-		form = LEB128(abbrev);
-
-		if (attr == 0 && form == 0)
-			break;
-
-		while (form == DW_FORM_indirect)
-			form = LEB128(ptr);
-
-		DWARF_Attribute a;
-		switch (form)
-		{
-			case DW_FORM_addr:           a.type = Addr; a.addr = (unsigned long)RDsize(ptr, cu->address_size); break;
-			case DW_FORM_block:          a.type = Block; a.block.len = LEB128(ptr); a.block.ptr = ptr; ptr += a.block.len; break;
-			case DW_FORM_block1:         a.type = Block; a.block.len = *ptr++;      a.block.ptr = ptr; ptr += a.block.len; break;
-			case DW_FORM_block2:         a.type = Block; a.block.len = RD2(ptr);   a.block.ptr = ptr; ptr += a.block.len; break;
-			case DW_FORM_block4:         a.type = Block; a.block.len = RD4(ptr);   a.block.ptr = ptr; ptr += a.block.len; break;
-			case DW_FORM_data1:          a.type = Const; a.cons = *ptr++; break;
-			case DW_FORM_data2:          a.type = Const; a.cons = RD2(ptr); break;
-			case DW_FORM_data4:          a.type = Const; a.cons = RD4(ptr); break;
-			case DW_FORM_data8:          a.type = Const; a.cons = RD8(ptr); break;
-			case DW_FORM_sdata:          a.type = Const; a.cons = SLEB128(ptr); break;
-			case DW_FORM_udata:          a.type = Const; a.cons = LEB128(ptr); break;
-			case DW_FORM_string:         a.type = String; a.string = (const char*)ptr; ptr += strlen(a.string) + 1; break;
-			case DW_FORM_strp:           a.type = String; a.string = (const char*)(img->debug_str + RDsize(ptr, cu->address_size)); break;
-			case DW_FORM_flag:           a.type = Flag; a.flag = (*ptr++ != 0); break;
-			case DW_FORM_flag_present:   a.type = Flag; a.flag = true; break;
-			case DW_FORM_ref1:           a.type = Ref; a.ref = (byte*)cu + *ptr++; break;
-			case DW_FORM_ref2:           a.type = Ref; a.ref = (byte*)cu + RD2(ptr); break;
-			case DW_FORM_ref4:           a.type = Ref; a.ref = (byte*)cu + RD4(ptr); break;
-			case DW_FORM_ref8:           a.type = Ref; a.ref = (byte*)cu + RD8(ptr); break;
-			case DW_FORM_ref_udata:      a.type = Ref; a.ref = (byte*)cu + LEB128(ptr); break;
-			case DW_FORM_ref_addr:       a.type = Ref; a.ref = (byte*)img->debug_info + (cu->isDWARF64() ? RD8(ptr) : RD4(ptr)); break;
-			case DW_FORM_ref_sig8:       a.type = Invalid; ptr += 8;  break;
-			case DW_FORM_exprloc:        a.type = ExprLoc; a.expr.len = LEB128(ptr); a.expr.ptr = ptr; ptr += a.expr.len; break;
-			case DW_FORM_sec_offset:     a.type = SecOffset;  a.sec_offset = cu->isDWARF64() ? RD8(ptr) : RD4(ptr); break;
-			case DW_FORM_indirect:
-			default: assert(false && "Unsupported DWARF attribute form"); return false;
-		}
-
-		switch (attr)
-		{
-			case DW_AT_byte_size: assert(a.type == Const); id.byte_size = a.cons; break;
-			case DW_AT_sibling:   assert(a.type == Ref); id.sibling = a.ref; break;
-			case DW_AT_encoding:  assert(a.type == Const); id.encoding = a.cons; break;
-			case DW_AT_name:      assert(a.type == String); id.name = a.string; break;
-			case DW_AT_MIPS_linkage_name: assert(a.type == String); id.linkage_name = a.string; break;
-			case DW_AT_comp_dir:  assert(a.type == String); id.dir = a.string; break;
-			case DW_AT_low_pc:    assert(a.type == Addr); id.pclo = a.addr; break;
-			case DW_AT_high_pc:
-				if (a.type == Addr)
-					id.pchi = a.addr;
-				else if (a.type == Const)
-					id.pchi = id.pclo + a.cons;
-				else
-					assert(false);
-			break;
-			case DW_AT_ranges:    assert(a.type == SecOffset); id.ranges = a.sec_offset; break;
-			case DW_AT_type:      assert(a.type == Ref); id.type = a.ref; break;
-			case DW_AT_inline:    assert(a.type == Const); id.inlined = a.cons; break;
-			case DW_AT_external:  assert(a.type == Flag); id.external = a.flag; break;
-			case DW_AT_upper_bound: assert(a.type == Const); id.upper_bound = a.cons; break;
-			case DW_AT_lower_bound: assert(a.type == Const); id.lower_bound = a.cons; break;
-			case DW_AT_containing_type: assert(a.type == Ref); id.containing_type = a.ref; break;
-			case DW_AT_specification: assert(a.type == Ref); id.specification = a.ref; break;
-			case DW_AT_data_member_location: id.member_location = a; break;
-			case DW_AT_location: id.location = a; break;
-			case DW_AT_frame_base: id.frame_base = a; break;
-		}
-	}
-
-	hasChild = id.hasChild != 0;
-	sibling = id.sibling;
-
-	return true;
-}
-
-byte* DIECursor::getDWARFAbbrev(unsigned off, unsigned findcode)
-{
-	if (!img->debug_abbrev)
-		return 0;
-
-	std::pair<unsigned, unsigned> key = std::make_pair(off, findcode);
-	abbrevMap_t::iterator it = abbrevMap.find(key);
-	if (it != abbrevMap.end())
-	{
-		return it->second;
-	}
-
-	byte* p = (byte*)img->debug_abbrev + off;
-	byte* end = (byte*)img->debug_abbrev + img->debug_abbrev_length;
-	while (p < end)
-	{
-		int code = LEB128(p);
-		if (code == findcode)
-		{
-			abbrevMap.insert(std::make_pair(key, p));
-			return p;
-		}
-		if (code == 0)
-			return 0;
-
-		int tag = LEB128(p);
-		int hasChild = *p++;
-
-		// skip attributes
-		int attr, form;
-		do
-		{
-			attr = LEB128(p);
-			form = LEB128(p);
-		} while (attr || form);
-	}
-	return 0;
-}
+#include "readDwarf.h"
+#include <assert.h>
+#include <unordered_map>
+#include <array>
+#include "pecoff.h"
+
+#include "PEImage.h"
+#include "dwarf.h"
+#include "mspdb.h"
+#include "stats.h"
+extern "C" {
+	#include "mscvpdb.h"
+}
+
+static PEImage* img;
+
+// entry idx of the address table of a DWARF 5 unit in .debug_addr
+static bool readIndexedAddr(unsigned long addrBase, int addrSize, unsigned long idx, unsigned long long& addr)
+{
+	unsigned long long off = addrBase + (unsigned long long) idx * addrSize;
+	if (!img || !img->debug_addr || off + addrSize > img->debug_addr_length)
+		return false;
+	byte* p = (byte*) img->debug_addr + off;
+	addr = RDaddr(p, addrSize);
+	return true;
+}
+
+static Location mkInReg(unsigned reg)
+{
+	Location l;
+	l.type = Location::InReg;
+	l.reg = reg;
+	l.off = 0;
+	return l;
+}
+
+static Location mkAbs(int off)
+{
+	Location l;
+	l.type = Location::Abs;
+	l.reg = 0;
+	l.off = off;
+	return l;
+}
+
+static Location mkRegRel(int reg, int off)
+{
+	Location l;
+	l.type = Location::RegRel;
+	l.reg = reg;
+	l.off = off;
+	return l;
+}
+
+// general interpreter for location expressions
+static Location evalLocation(const DWARF_Attribute& attr, const Location* frameBase)
+{
+	static Location invalid = { Location::Invalid };
+
+	byte* p = attr.expr.ptr;
+	Location stack[256];
+	int stackDepth = 0;
+
+	for (;;)
+	{
+		if (p >= attr.expr.ptr + attr.expr.len)
+			break;
+
+		int op = *p++;
+		if (op == 0)
+			break;
+
+		switch (op)
+		{
+			case DW_OP_reg0:  case DW_OP_reg1:  case DW_OP_reg2:  case DW_OP_reg3:
+			case DW_OP_reg4:  case DW_OP_reg5:  case DW_OP_reg6:  case DW_OP_reg7:
+			case DW_OP_reg8:  case DW_OP_reg9:  case DW_OP_reg10: case DW_OP_reg11:
+			case DW_OP_reg12: case DW_OP_reg13: case DW_OP_reg14: case DW_OP_reg15:
+			case DW_OP_reg16: case DW_OP_reg17: case DW_OP_reg18: case DW_OP_reg19:
+			case DW_OP_reg20: case DW_OP_reg21: case DW_OP_reg22: case DW_OP_reg23:
+			case DW_OP_reg24: case DW_OP_reg25: case DW_OP_reg26: case DW_OP_reg27:
+			case DW_OP_reg28: case DW_OP_reg29: case DW_OP_reg30: case DW_OP_reg31:
+				stack[stackDepth++] = mkInReg(op - DW_OP_reg0);
+				break;
+			case DW_OP_regx:
+				stack[stackDepth++] = mkInReg(LEB128(p));
+				break;
+
+			case DW_OP_const1u: stack[stackDepth++] = mkAbs(*p); break;
+			case DW_OP_const2u: stack[stackDepth++] = mkAbs(RD2(p)); break;
+			case DW_OP_const4u: stack[stackDepth++] = mkAbs(RD4(p)); break;
+			case DW_OP_const1s: stack[stackDepth++] = mkAbs((char)*p); break;
+			case DW_OP_const2s: stack[stackDepth++] = mkAbs((short)RD2(p)); break;
+			case DW_OP_const4s: stack[stackDepth++] = mkAbs((int)RD4(p)); break;
+			case DW_OP_constu:  stack[stackDepth++] = mkAbs(LEB128(p)); break;
+			case DW_OP_consts:  stack[stackDepth++] = mkAbs(SLEB128(p)); break;
+
+			case DW_OP_plus_uconst: 
+				if (stack[stackDepth - 1].is_inreg())
+					return invalid;
+				stack[stackDepth - 1].off += LEB128(p); 
+				break;
+
+			case DW_OP_lit0:  case DW_OP_lit1:  case DW_OP_lit2:  case DW_OP_lit3:
+			case DW_OP_lit4:  case DW_OP_lit5:  case DW_OP_lit6:  case DW_OP_lit7:
+			case DW_OP_lit8:  case DW_OP_lit9:  case DW_OP_lit10: case DW_OP_lit11:
+			case DW_OP_lit12: case DW_OP_lit13: case DW_OP_lit14: case DW_OP_lit15:
+			case DW_OP_lit16: case DW_OP_lit17: case DW_OP_lit18: case DW_OP_lit19:
+			case DW_OP_lit20: case DW_OP_lit21: case DW_OP_lit22: case DW_OP_lit23:
+				stack[stackDepth++] = mkAbs(op - DW_OP_lit0);
+				break;
+
+			case DW_OP_breg0:  case DW_OP_breg1:  case DW_OP_breg2:  case DW_OP_breg3:
+			case DW_OP_breg4:  case DW_OP_breg5:  case DW_OP_breg6:  case DW_OP_breg7:
+			case DW_OP_breg8:  case DW_OP_breg9:  case DW_OP_breg10: case DW_OP_breg11:
+			case DW_OP_breg12: case DW_OP_breg13: case DW_OP_breg14: case DW_OP_breg15:
+			case DW_OP_breg16: case DW_OP_breg17: case DW_OP_breg18: case DW_OP_breg19:
+			case DW_OP_breg20: case DW_OP_breg21: case DW_OP_breg22: case DW_OP_breg23:
+			case DW_OP_breg24: case DW_OP_breg25: case DW_OP_breg26: case DW_OP_breg27:
+			case DW_OP_breg28: case DW_OP_breg29: case DW_OP_breg30: case DW_OP_breg31:
+				stack[stackDepth++] = mkRegRel(op - DW_OP_breg0, SLEB128(p));
+				break;
+			case DW_OP_bregx:
+			{
+				unsigned reg = LEB128(p);
+				stack[stackDepth++] = mkRegRel(reg, SLEB128(p));
+			}   break;
+
+
+			case DW_OP_abs: case DW_OP_neg: case DW_OP_not:
+			{
+				Location& op1 = stack[stackDepth - 1];
+				if (!op1.is_abs())
+					return invalid;
+				switch (op)
+				{
+					case DW_OP_abs:   op1 = mkAbs(abs(op1.off)); break;
+					case DW_OP_neg:   op1 = mkAbs(-op1.off); break;
+					case DW_OP_not:   op1 = mkAbs(~op1.off); break;
+				}
+			}   break;
+
+			case DW_OP_plus:  // op2 + op1
+			{
+				Location& op1 = stack[stackDepth - 1];
+				Location& op2 = stack[stackDepth - 2];
+				// Can add only two offsets or a regrel and an offset.
+				if (op2.is_regrel() && op1.is_abs())
+					op2 = mkRegRel(op2.reg, op2.off + op1.off);
+				else if (op2.is_abs() && op1.is_regrel())
+					op2 = mkRegRel(op1.reg, op2.off + op1.off);
+				else if (op2.is_abs() && op1.is_abs())
+					op2 = mkAbs(op2.off + op1.off);
+				else
+					return invalid;
+				--stackDepth;
+			}   break;
+
+			case DW_OP_minus: // op2 - op1
+			{
+				Location& op1 = stack[stackDepth - 1];
+				Location& op2 = stack[stackDepth - 2];
+				if (op2.is_regrel() && op1.is_regrel() && op2.reg == op1.reg)
+					op2 = mkAbs(0); // X - X == 0
+				else if (op2.is_regrel() && op1.is_abs())
+					op2 = mkRegRel(op2.reg, op2.off - op1.off);
+				else if (op2.is_abs() && op1.is_abs())
+					op2 = mkAbs(op2.off - op1.off);
+				else
+					return invalid;
+				--stackDepth;
+			}   break;
+
+			case DW_OP_mul:
+			{
+				Location& op1 = stack[stackDepth - 1];
+				Location& op2 = stack[stackDepth - 2];
+				if ((op1.is_abs() && op1.off == 0) || (op2.is_abs() && op2.off == 0))
+					op2 = mkAbs(0); // X * 0 == 0
+				else if (op1.is_abs() && op2.is_abs())
+					op2 = mkAbs(op1.off * op2.off);
+				else
+					return invalid;
+				--stackDepth;
+			}   break;
+
+			case DW_OP_and:
+			{
+				Location& op1 = stack[stackDepth - 1];
+				Location& op2 = stack[stackDepth - 2];
+				if ((op1.is_abs() && op1.off == 0) || (op2.is_abs() && op2.off == 0))
+					op2 = mkAbs(0); // X & 0 == 0
+				else if (op1.is_abs() && op2.is_abs())
+					op2 = mkAbs(op1.off & op2.off);
+				else
+					return invalid;
+				--stackDepth;
+			}   break;
+
+			case DW_OP_div: case DW_OP_mod: case DW_OP_shl:
+			case DW_OP_shr: case DW_OP_shra: case DW_OP_or:
+			case DW_OP_xor:
+			case DW_OP_eq:  case DW_OP_ge:  case DW_OP_gt:
+			case DW_OP_le:  case DW_OP_lt:  case DW_OP_ne:
+			{
+				Location& op1 = stack[stackDepth - 1];
+				Location& op2 = stack[stackDepth - 2];
+				if (!op1.is_abs() || !op2.is_abs()) // can't combine unless both are constants
+					return invalid;
+				switch (op)
+				{
+					case DW_OP_div:   op2.off = op2.off / op1.off; break;
+					case DW_OP_mod:   op2.off = op2.off % op1.off; break;
+					case DW_OP_shl:   op2.off = op2.off << op1.off; break;
+					case DW_OP_shr:   op2.off = op2.off >> op1.off; break;
+					case DW_OP_shra:  op2.off = op2.off >> op1.off; break;
+					case DW_OP_or:    op2.off = op2.off | op1.off; break;
+					case DW_OP_xor:   op2.off = op2.off ^ op1.off; break;
+					case DW_OP_eq:    op2.off = op2.off == op1.off; break;
+					case DW_OP_ge:    op2.off = op2.off >= op1.off; break;
+					case DW_OP_gt:    op2.off = op2.off > op1.off; break;
+					case DW_OP_le:    op2.off = op2.off <= op1.off; break;
+					case DW_OP_lt:    op2.off = op2.off < op1.off; break;
+					case DW_OP_ne:    op2.off = op2.off != op1.off; break;
+				}
+				--stackDepth;
+			}   break;
+
+			case DW_OP_fbreg:
+			{
+				if (!frameBase)
+					return invalid;
+
+				Location loc;
+				if (frameBase->is_inreg()) // ok in frame base specification, per DWARF4 spec #3.3.5
+					loc = mkRegRel(frameBase->reg, SLEB128(p));
+				else if (frameBase->is_regrel())
+					loc = mkRegRel(frameBase->reg, frameBase->off + SLEB128(p));
+				else
+					return invalid;
+				stack[stackDepth++] = loc;
+			}   break;
+
+			case DW_OP_dup:   stack[stackDepth] = stack[stackDepth - 1]; stackDepth++; break;
+			case DW_OP_drop:  stackDepth--; break;
+			case DW_OP_over:  stack[stackDepth] = stack[stackDepth - 2]; stackDepth++; break;
+			case DW_OP_pick:  stack[stackDepth++] = stack[*p]; break;
+			case DW_OP_swap:  { Location tmp = stack[stackDepth - 1]; stack[stackDepth - 1] = stack[stackDepth - 2]; stack[stackDepth - 2] = tmp; } break;
+			case DW_OP_rot:   { Location tmp = stack[stackDepth - 1]; stack[stackDepth - 1] = stack[stackDepth - 2]; stack[stackDepth - 2] = stack[stackDepth - 3]; stack[stackDepth - 3] = tmp; } break;
+
+			case DW_OP_addr:
+				stack[stackDepth++] = mkAbs((int) RDsize(p, attr.expr.addrSize)); // low 32 bits, relative to the image base
+				break;
+			case DW_OP_addrx:
+			case DW_OP_constx:
+			{
+				unsigned long long addr;
+				if (!readIndexedAddr(attr.expr.addrBase, attr.expr.addrSize, LEB128(p), addr))
+					return invalid;
+				stack[stackDepth++] = mkAbs((int) addr);
+			}   break;
+
+			case DW_OP_skip:
+			{
+				unsigned off = RD2(p);
+				p = p + off;
+			}   break;
+
+			case DW_OP_bra:
+			{
+				Location& op1 = stack[stackDepth - 1];
+				if (!op1.is_abs())
+					return invalid;
+				if (op1.off != 0)
+				{
+					unsigned off = RD2(p);
+					p = p + off;
+				}
+				--stackDepth;
+			}   break;
+
+			case DW_OP_nop:
+				break;
+
+			case DW_OP_deref:
+			case DW_OP_deref_size:
+			case DW_OP_push_object_address:
+			case DW_OP_call2:
+			case DW_OP_call4:
+			case DW_OP_form_tls_address:
+			case DW_OP_call_frame_cfa:
+			case DW_OP_call_ref:
+			case DW_OP_bit_piece:
+			case DW_OP_implicit_value:
+			case DW_OP_stack_value:
+			default:
+				return invalid;
+		}
+	}
+
+	assert(stackDepth > 0);
+	return stack[0];
+}
+
+// decode expressions consisting of a single operation, as emitted for most
+// variables and members. Returns false if the interpreter is needed.
+static bool decodeSimpleLocation(byte* p, unsigned len, int addrSize, unsigned long addrBase,
+                                 const Location* frameBase, Location& loc)
+{
+	if (len == 0)
+	{
+		loc.type = Location::Invalid;
+		return true;
+	}
+
+	byte* end = p + len;
+	int op = *p++;
+	if (op >= DW_OP_reg0 && op <= DW_OP_reg31)
+		loc = mkInReg(op - DW_OP_reg0);
+	else if (op >= DW_OP_breg0 && op <= DW_OP_breg31)
+		loc = mkRegRel(op - DW_OP_breg0, SLEB128(p, end));
+	else if (op >= DW_OP_lit0 && op <= DW_OP_lit23)
+		loc = mkAbs(op - DW_OP_lit0);
+	else switch (op)
+	{
+		case DW_OP_regx:        loc = mkInReg(LEB128(p, end)); break;
+		case DW_OP_plus_uconst: loc = mkAbs(LEB128(p, end)); break; // member offset, the object address is implied
+		case DW_OP_constu:      loc = mkAbs(LEB128(p, end)); break;
+		case DW_OP_consts:      loc = mkAbs(SLEB128(p, end)); break;
+		case DW_OP_addr:
+			if (end - p != addrSize)
+				return false;
+			loc = mkAbs((int) RDsize(p, addrSize)); // low 32 bits, relative to the image base
+			break;
+		case DW_OP_addrx:
+		{
+			unsigned long long addr;
+			if (readIndexedAddr(addrBase, addrSize, LEB128(p, end), addr))
+				loc = mkAbs((int) addr);
+			else
+				loc.type = Location::Invalid;
+		}   break;
+		case DW_OP_fbreg:
+		{
+			int off = SLEB128(p, end);
+			if (frameBase && frameBase->is_inreg())
+				loc = mkRegRel(frameBase->reg, off);
+			else if (frameBase && frameBase->is_regrel())
+				loc = mkRegRel(frameBase->reg, frameBase->off + off);
+			else
+				loc.type = Location::Invalid;
+		}   break;
+		default:
+			return false;
+	}
+	return p == end;
+}
+
+// small direct mapped cache of interpreted expressions, keyed by content and frame base
+static const unsigned kLocationCacheSize = 256;
+static const unsigned kMaxCachedLocationLen = 16;
+
+struct LocationCacheEntry
+{
+	unsigned len; // 0 if unused
+	byte expr[kMaxCachedLocationLen];
+	Location frameBase;
+	unsigned addrBase; // for DW_OP_addrx
+	Location loc;
+};
+
+static LocationCacheEntry locationCache[kLocationCacheSize];
+
+static bool sameLocation(const Location& l1, const Location& l2)
+{
+	return l1.type == l2.type && l1.reg == l2.reg && l1.off == l2.off;
+}
+
+Location decodeLocation(const DWARF_Attribute& attr, const Location* frameBase)
+{
+	static Location invalid = { Location::Invalid };
+
+	if (attr.type == Const)
+		return mkAbs(attr.cons);
+
+	if (attr.type != ExprLoc)
+		return invalid;
+
+	countStat(kStatLocations);
+	Location loc;
+	if (decodeSimpleLocation(attr.expr.ptr, attr.expr.len, attr.expr.addrSize, attr.expr.addrBase, frameBase, loc))
+		return loc;
+
+	if (attr.expr.len > kMaxCachedLocationLen)
+	{
+		countStat(kStatLocationsEvaluated);
+		return evalLocation(attr, frameBase);
+	}
+
+	Location fb = invalid;
+	fb.reg = fb.off = 0;
+	if (frameBase && !frameBase->is_invalid())
+		fb = *frameBase;
+
+	unsigned hash = fb.type * 31 + fb.reg * 17 + fb.off + attr.expr.addrBase;
+	for (unsigned i = 0; i < attr.expr.len; i++)
+		hash = hash * 131 + attr.expr.ptr[i];
+	LocationCacheEntry& entry = locationCache[hash % kLocationCacheSize];
+
+	if (entry.len == attr.expr.len && sameLocation(entry.frameBase, fb) && entry.addrBase == attr.expr.addrBase
+	    && memcmp(entry.expr, attr.expr.ptr, attr.expr.len) == 0)
+		return entry.loc;
+
+	countStat(kStatLocationsEvaluated);
+	loc = evalLocation(attr, frameBase);
+
+	entry.len = attr.expr.len;
+	memcpy(entry.expr, attr.expr.ptr, attr.expr.len);
+	entry.frameBase = fb;
+	entry.addrBase = attr.expr.addrBase;
+	entry.loc = loc;
+	return loc;
+}
+
+// declare hasher for pair<T1,T2>
+namespace std
+{
+	template<typename T1, typename T2>
+	struct hash<std::pair<T1, T2>>
+	{
+		size_t operator()(const std::pair<T1, T2>& t) const
+		{
+			return std::hash<T1>()(t.first) ^ std::hash<T2>()(t.second);
+		}
+	};
+}
+
+typedef std::unordered_map<std::pair<unsigned, unsigned>, DWARF_Abbrev> abbrevMap_t;
+
+static abbrevMap_t abbrevMap;
+static std::vector<byte> abbrevData; // copy of .debug_abbrev the cached abbreviations point into
+
+// attributes of the unit DIE needed to decode the other DIEs of the unit
+struct DWARF_UnitBases
+{
+	DWARF_CompilationUnit* cu;
+	unsigned long lowPC;      // base address of range lists
+	unsigned long strOffsets; // DWARF 5 tables of DW_FORM_strx, DW_FORM_addrx and DW_FORM_rnglistx
+	unsigned long addr;
+	unsigned long rnglists;
+};
+
+static DWARF_UnitBases unitBases; // of the unit looked up last
+
+// read an attribute specification of an abbreviation, the value of DW_FORM_implicit_const
+// is part of the specification. Returns false at the end of the specifications.
+static inline bool readAttrSpec(byte* &spec, byte* end, int& attr, int& form, int& implicitConst)
+{
+	attr = LEB128(spec, end);
+	form = LEB128(spec, end);
+	if (form == DW_FORM_implicit_const)
+		implicitConst = SLEB128(spec, end);
+	return attr != 0 || form != 0;
+}
+
+void DIECursor::setContext(PEImage* img_)
+{
+	img = img_;
+	unitBases.cu = 0;
+
+	// keep the cache for the next image with the same abbreviations, e.g. when
+	// the conversion server converts a rebuild or images from the same compiler
+	byte* abbrev = (byte*)img->debug_abbrev;
+	size_t len = abbrev ? img->debug_abbrev_length : 0;
+	if (len == abbrevData.size() && (len == 0 || memcmp(abbrev, abbrevData.data(), len) == 0))
+		return;
+
+	abbrevData.assign(abbrev, abbrev + len);
+	abbrevMap.clear();
+}
+
+void DIECursor::limitAbbrevCache(size_t maxBytes)
+{
+	// key, value and the node and bucket overhead of the hash map
+	size_t entrySize = sizeof(abbrevMap_t::value_type) + 4 * sizeof(void*);
+	if (abbrevMap.size() * entrySize > maxBytes)
+		abbrevMap = abbrevMap_t(); // release the buckets, too
+}
+
+
+DIECursor::DIECursor(DWARF_CompilationUnit* cu_, byte* ptr_)
+{
+	cu = cu_;
+	ptr = ptr_;
+	level = 0;
+	hasChild = false;
+	sibling = 0;
+
+	// PE images only have 4 or 8 byte addresses, others use the generic reader
+	if (cu->isDWARF64())
+		readNextImpl = cu->addressSize() == 4 ? &DIECursor::readNextT<4, 8>
+		             : cu->addressSize() == 8 ? &DIECursor::readNextT<8, 8> : &DIECursor::readNextT<0, 8>;
+	else
+		readNextImpl = cu->addressSize() == 4 ? &DIECursor::readNextT<4, 4>
+		             : cu->addressSize() == 8 ? &DIECursor::readNextT<8, 4> : &DIECursor::readNextT<0, 4>;
+}
+
+
+bool DIECursor::readSibling(DWARF_InfoData& id)
+{
+	if (sibling)
+	{
+		// use sibling pointer, if available
+		ptr = sibling;
+		hasChild = false;
+	} 
+	else if (hasChild)
+	{
+		int currLevel = level;
+		level = currLevel + 1;
+		hasChild = false;
+
+		// skip untill we pop back to the level we were at
+		while (level > currLevel)
+			if (!skipNext())
+				break;
+	}
+
+	return readNext(id, true);
+}
+
+bool DIECursor::readSibling(DWARF_DIEView& die)
+{
+	if (sibling)
+	{
+		ptr = sibling;
+		hasChild = false;
+	}
+	else if (hasChild)
+	{
+		int currLevel = level;
+		level = currLevel + 1;
+		hasChild = false;
+
+		while (level > currLevel)
+			if (!skipNext())
+				break;
+	}
+
+	return readNext(die, true);
+}
+
+DIECursor DIECursor::getSubtreeCursor()
+{
+	if (hasChild)
+	{
+		DIECursor subtree = *this;
+		subtree.level = 0;
+		subtree.hasChild = false;
+		return subtree;
+	}
+	else // Return invalid cursor
+	{
+		DIECursor subtree = *this;
+		subtree.level = -1;
+		return subtree;
+	}
+}
+
+// size of attribute values with a fixed encoding independent of the CU, -1 for others
+static int constFormSize(int form)
+{
+	switch (form)
+	{
+		case DW_FORM_flag_present:
+		case DW_FORM_implicit_const: return 0;
+		case DW_FORM_data1:
+		case DW_FORM_ref1:
+		case DW_FORM_flag:
+		case DW_FORM_strx1:
+		case DW_FORM_addrx1:         return 1;
+		case DW_FORM_data2:
+		case DW_FORM_ref2:
+		case DW_FORM_strx2:
+		case DW_FORM_addrx2:         return 2;
+		case DW_FORM_strx3:
+		case DW_FORM_addrx3:         return 3;
+		case DW_FORM_data4:
+		case DW_FORM_ref4:
+		case DW_FORM_ref_sup4:
+		case DW_FORM_strx4:
+		case DW_FORM_addrx4:         return 4;
+		case DW_FORM_data8:
+		case DW_FORM_ref8:
+		case DW_FORM_ref_sig8:
+		case DW_FORM_ref_sup8:       return 8;
+		case DW_FORM_data16:         return 16;
+		default:                     return -1;
+	}
+}
+
+// forms with the offset size of the CU
+static bool isOffsetForm(int form)
+{
+	return form == DW_FORM_strp || form == DW_FORM_ref_addr || form == DW_FORM_sec_offset
+	    || form == DW_FORM_line_strp || form == DW_FORM_strp_sup;
+}
+
+// size of attribute values with a fixed encoding, -1 for variable length forms
+static int fixedFormSize(int form, const DWARF_CompilationUnit* cu)
+{
+	if (form == DW_FORM_addr)
+		return cu->addressSize();
+	if (isOffsetForm(form))
+		return cu->refSize();
+	return constFormSize(form);
+}
+
+// skip an attribute value without decoding it, values extending beyond
+// end are clamped to end, 0 for unknown forms
+static byte* skipForm(const DWARF_CompilationUnit* cu, byte* ptr, byte* end, int form)
+{
+	int size = fixedFormSize(form, cu);
+	if (size >= 0)
+		return size < end - ptr ? ptr + size : end;
+
+	unsigned long len;
+	switch (form)
+	{
+		case DW_FORM_block:
+		case DW_FORM_exprloc:        len = LEB128(ptr, end); break;
+		case DW_FORM_block1:         if (end - ptr < 1) return end; len = *ptr++; break;
+		case DW_FORM_block2:         if (end - ptr < 2) return end; len = RD2(ptr); break;
+		case DW_FORM_block4:         if (end - ptr < 4) return end; len = RD4(ptr); break;
+		case DW_FORM_sdata:
+		case DW_FORM_udata:
+		case DW_FORM_ref_udata:
+		case DW_FORM_strx:
+		case DW_FORM_addrx:
+		case DW_FORM_loclistx:
+		case DW_FORM_rnglistx:       LEB128(ptr, end); return ptr;
+		case DW_FORM_string:
+		{
+			byte* nul = (byte*) memchr(ptr, 0, end - ptr);
+			return nul ? nul + 1 : end;
+		}
+		case DW_FORM_indirect:       form = LEB128(ptr, end); return skipForm(cu, ptr, end, form);
+		default: assert(false && "Unsupported DWARF attribute form"); return 0;
+	}
+	return len < (unsigned long) (end - ptr) ? ptr + len : end;
+}
+
+static const DWARF_UnitBases& getUnitBases(DWARF_CompilationUnit* cu)
+{
+	if (unitBases.cu == cu)
+		return unitBases;
+
+	memset(&unitBases, 0, sizeof(unitBases));
+	unitBases.cu = cu;
+
+	byte* ptr = cu->firstDIE();
+	byte* end = cu->end();
+	unsigned code = ptr < end ? LEB128(ptr, end) : 0;
+	const DWARF_Abbrev* abbrev = code ? DIECursor::getAbbrev(cu->abbrevOffset(), code) : 0;
+	if (!abbrev)
+		return unitBases;
+
+	// DW_AT_addr_base can follow DW_AT_low_pc
+	bool lowPCIndexed = false;
+	byte* abbrevEnd = abbrevData.data() + abbrevData.size();
+	byte* spec = abbrev->attrs;
+	int attr, form, implicitConst;
+	while (ptr && readAttrSpec(spec, abbrevEnd, attr, form, implicitConst))
+	{
+		unsigned long* base = attr == DW_AT_str_offsets_base ? &unitBases.strOffsets
+		                    : attr == DW_AT_addr_base ? &unitBases.addr
+		                    : attr == DW_AT_rnglists_base ? &unitBases.rnglists : 0;
+		int size = fixedFormSize(form, cu);
+		if (size > end - ptr)
+			break;
+		if (base && form == DW_FORM_sec_offset)
+			*base = (unsigned long) RDsize(ptr, size);
+		else if (attr == DW_AT_low_pc && form == DW_FORM_addr)
+			unitBases.lowPC = (unsigned long) RDsize(ptr, size);
+		else if (attr == DW_AT_low_pc && (form == DW_FORM_addrx || (form >= DW_FORM_addrx1 && form <= DW_FORM_addrx4)))
+		{
+			unitBases.lowPC = form == DW_FORM_addrx ? LEB128(ptr, end) : (unsigned long) RDsize(ptr, size);
+			lowPCIndexed = true;
+		}
+		else
+			ptr = skipForm(cu, ptr, end, form);
+	}
+
+	unsigned long long addr;
+	if (lowPCIndexed)
+		unitBases.lowPC = readIndexedAddr(unitBases.addr, cu->addressSize(), unitBases.lowPC, addr) ? (unsigned long) addr : 0;
+	return unitBases;
+}
+
+// entry idx of the string offsets table of a DWARF 5 unit
+static const char* indexedString(DWARF_CompilationUnit* cu, unsigned long idx)
+{
+	int offSize = cu->refSize();
+	unsigned long long off = getUnitBases(cu).strOffsets + (unsigned long long) idx * offSize;
+	if (!img->debug_str_offsets || off + offSize > img->debug_str_offsets_length)
+		return "";
+	byte* p = (byte*) img->debug_str_offsets + off;
+	unsigned long long stroff = RDsize(p, offSize);
+	if (!img->debug_str || stroff >= img->debug_str_length)
+		return "";
+	return img->debug_str + stroff;
+}
+
+static unsigned long indexedAddr(DWARF_CompilationUnit* cu, unsigned long idx)
+{
+	unsigned long long addr = 0;
+	readIndexedAddr(getUnitBases(cu).addr, cu->addressSize(), idx, addr);
+	return (unsigned long) addr;
+}
+
+// offset of range list idx of a DWARF 5 unit, relative to the offsets table
+static unsigned long indexedRangeList(DWARF_CompilationUnit* cu, unsigned long idx)
+{
+	int offSize = cu->refSize();
+	unsigned long base = getUnitBases(cu).rnglists;
+	unsigned long long off = base + (unsigned long long) idx * offSize;
+	if (!img->debug_rnglists || off + offSize > img->debug_rnglists_length)
+		return ~0UL;
+	byte* p = (byte*) img->debug_rnglists + off;
+	return base + (unsigned long) RDsize(p, offSize);
+}
+
+// AddrSize 0: use address size of the CU
+template<int AddrSize, int OffSize>
+static bool readAttr(DWARF_CompilationUnit* cu, byte* &ptr, byte* end, int form, int implicitConst, DWARF_Attribute& a)
+{
+	while (form == DW_FORM_indirect)
+		form = LEB128(ptr, end);
+
+	switch (form)
+	{
+		case DW_FORM_addr:           a.type = Addr; a.addr = (unsigned long)(AddrSize ? RDfixed<AddrSize>(ptr) : RDsize(ptr, cu->addressSize())); break;
+		case DW_FORM_block:          a.type = Block; a.block.len = LEB128(ptr, end); a.block.ptr = ptr; ptr += a.block.len; break;
+		case DW_FORM_block1:         a.type = Block; a.block.len = *ptr++;      a.block.ptr = ptr; ptr += a.block.len; break;
+		case DW_FORM_block2:         a.type = Block; a.block.len = RD2(ptr);   a.block.ptr = ptr; ptr += a.block.len; break;
+		case DW_FORM_block4:         a.type = Block; a.block.len = RD4(ptr);   a.block.ptr = ptr; ptr += a.block.len; break;
+		case DW_FORM_data1:          a.type = Const; a.cons = *ptr++; break;
+		case DW_FORM_data2:          a.type = Const; a.cons = RDfixed<2>(ptr); break;
+		case DW_FORM_data4:          a.type = Const; a.cons = RDfixed<4>(ptr); break;
+		case DW_FORM_data8:          a.type = Const; a.cons = RDfixed<8>(ptr); break;
+		case DW_FORM_sdata:          a.type = Const; a.cons = SLEB128(ptr, end); break;
+		case DW_FORM_udata:          a.type = Const; a.cons = LEB128(ptr, end); break;
+		case DW_FORM_string:         a.type = String; a.string = (const char*)ptr; ptr += strlen(a.string) + 1; break;
+		case DW_FORM_strp:           a.type = String; a.string = (const char*)(img->debug_str + RDfixed<OffSize>(ptr)); break;
+		case DW_FORM_flag:           a.type = Flag; a.flag = (*ptr++ != 0); break;
+		case DW_FORM_flag_present:   a.type = Flag; a.flag = true; break;
+		case DW_FORM_ref1:           a.type = Ref; a.ref = (byte*)cu + *ptr++; break;
+		case DW_FORM_ref2:           a.type = Ref; a.ref = (byte*)cu + RDfixed<2>(ptr); break;
+		case DW_FORM_ref4:           a.type = Ref; a.ref = (byte*)cu + RDfixed<4>(ptr); break;
+		case DW_FORM_ref8:           a.type = Ref; a.ref = (byte*)cu + RDfixed<8>(ptr); break;
+		case DW_FORM_ref_udata:      a.type = Ref; a.ref = (byte*)cu + LEB128(ptr, end); break;
+		case DW_FORM_ref_addr:       a.type = Ref; a.ref = (byte*)img->debug_info + RDfixed<OffSize>(ptr); break;
+		case DW_FORM_ref_sig8:       a.type = Invalid; ptr += 8;  break;
+		case DW_FORM_exprloc:        a.type = ExprLoc; a.expr.len = LEB128(ptr, end); a.expr.ptr = ptr; ptr += a.expr.len;
+		                             a.expr.addrSize = AddrSize ? AddrSize : cu->addressSize();
+		                             a.expr.addrBase = cu->version >= 5 ? getUnitBases(cu).addr : 0; break;
+		case DW_FORM_sec_offset:     a.type = SecOffset;  a.sec_offset = RDfixed<OffSize>(ptr); break;
+		case DW_FORM_implicit_const: a.type = Const; a.cons = implicitConst; break;
+		case DW_FORM_data16:         a.type = Block; a.block.len = 16; a.block.ptr = ptr; ptr += 16; break;
+		case DW_FORM_line_strp:      a.type = String; a.string = (const char*)(img->debug_line_str + RDfixed<OffSize>(ptr)); break;
+		case DW_FORM_strx:           a.type = String; a.string = indexedString(cu, LEB128(ptr, end)); break;
+		case DW_FORM_strx1:          a.type = String; a.string = indexedString(cu, (unsigned long) RDfixed<1>(ptr)); break;
+		case DW_FORM_strx2:          a.type = String; a.string = indexedString(cu, (unsigned long) RDfixed<2>(ptr)); break;
+		case DW_FORM_strx3:          a.type = String; a.string = indexedString(cu, (unsigned long) RDsize(ptr, 3)); break;
+		case DW_FORM_strx4:          a.type = String; a.string = indexedString(cu, (unsigned long) RDfixed<4>(ptr)); break;
+		case DW_FORM_addrx:          a.type = Addr; a.addr = indexedAddr(cu, LEB128(ptr, end)); break;
+		case DW_FORM_addrx1:         a.type = Addr; a.addr = indexedAddr(cu, (unsigned long) RDfixed<1>(ptr)); break;
+		case DW_FORM_addrx2:         a.type = Addr; a.addr = indexedAddr(cu, (unsigned long) RDfixed<2>(ptr)); break;
+		case DW_FORM_addrx3:         a.type = Addr; a.addr = indexedAddr(cu, (unsigned long) RDsize(ptr, 3)); break;
+		case DW_FORM_addrx4:         a.type = Addr; a.addr = indexedAddr(cu, (unsigned long) RDfixed<4>(ptr)); break;
+		case DW_FORM_rnglistx:       a.type = SecOffset; a.sec_offset = indexedRangeList(cu, LEB128(ptr, end)); break;
+		case DW_FORM_loclistx:       a.type = Invalid; LEB128(ptr, end); break; // location lists are not converted
+		// supplementary object files are not supported
+		case DW_FORM_strp_sup:       a.type = String; a.string = ""; ptr += OffSize; break;
+		case DW_FORM_ref_sup4:       a.type = Invalid; ptr += 4; break;
+		case DW_FORM_ref_sup8:       a.type = Invalid; ptr += 8; break;
+		case DW_FORM_indirect:
+		default: assert(false && "Unsupported DWARF attribute form"); return false;
+	}
+	return true;
+}
+
+// decode with the sizes of the CU, used outside of the specialized readers
+static bool readAttr(DWARF_CompilationUnit* cu, byte* &ptr, byte* end, int form, int implicitConst, DWARF_Attribute& a)
+{
+	if (cu->isDWARF64())
+		return readAttr<0, 8>(cu, ptr, end, form, implicitConst, a);
+	return readAttr<0, 4>(cu, ptr, end, form, implicitConst, a);
+}
+
+// AddrSize 0: use address size of the CU
+template<int AddrSize, int OffSize>
+bool DIECursor::readNextT(DWARF_InfoData& id, bool stopAtNull)
+{
+	id.clear();
+
+	if (hasChild)
+		++level;
+
+	byte* end = cu->end();
+	for (;;)
+	{
+		if (level == -1)
+			return false; // we were already at the end of the subtree
+
+		if (ptr >= end)
+			return false; // root of the tree does not have a null terminator, but we know the length
+
+		id.entryPtr = ptr;
+		id.entryOff = ptr - (byte*)cu;
+		id.code = LEB128(ptr, end);
+		if (id.code == 0)
+		{
+			--level; // pop up one level
+			if (stopAtNull)
+			{
+				hasChild = false;
+				return false;
+			}
+			continue; // read the next DIE
+		}
+
+		break;
+	}
+
+	countStat(kStatDIEs);
+	byte* abbrev = getDWARFAbbrev(cu->abbrevOffset(), id.code);
+	assert(abbrev);
+	if (!abbrev)
+		return false;
+
+	byte* abbrevEnd = abbrevData.data() + abbrevData.size();
+	id.abbrev = abbrev;
+	id.tag = LEB128(abbrev, abbrevEnd);
+	id.hasChild = *abbrev++;
+
+	int attr, form, implicitConst;
+	while (readAttrSpec(abbrev, abbrevEnd, attr, form, implicitConst))
+	{
+		DWARF_Attribute a;
+		if (!readAttr<AddrSize, OffSize>(cu, ptr, end, form, implicitConst, a))
+			return false;
+
+		switch (attr)
+		{
+			case DW_AT_byte_size: assert(a.type == Const); id.byte_size = a.cons; break;
+			case DW_AT_sibling:   assert(a.type == Ref); id.sibling = a.ref; break;
+			case DW_AT_encoding:  assert(a.type == Const); id.encoding = a.cons; break;
+			case DW_AT_name:      assert(a.type == String); id.name = a.string; break;
+			case DW_AT_MIPS_linkage_name: assert(a.type == String); id.linkage_name = a.string; break;
+			case DW_AT_comp_dir:  assert(a.type == String); id.dir = a.string; break;
+			case DW_AT_low_pc:    assert(a.type == Addr); id.pclo = a.addr; break;
+			case DW_AT_high_pc:
+				if (a.type == Addr)
+					id.pchi = a.addr;
+				else if (a.type == Const)
+					id.pchi = id.pclo + a.cons;
+				else
+					assert(false);
+			break;
+			case DW_AT_ranges:    assert(a.type == SecOffset); id.ranges = a.sec_offset; break;
+			case DW_AT_type:      assert(a.type == Ref); id.type = a.ref; break;
+			case DW_AT_inline:    assert(a.type == Const); id.inlined = a.cons; break;
+			case DW_AT_external:  assert(a.type == Flag); id.external = a.flag; break;
+			case DW_AT_upper_bound: assert(a.type == Const); id.upper_bound = a.cons; break;
+			case DW_AT_lower_bound: assert(a.type == Const); id.lower_bound = a.cons; break;
+			case DW_AT_containing_type: assert(a.type == Ref); id.containing_type = a.ref; break;
+			case DW_AT_specification: assert(a.type == Ref); id.specification = a.ref; break;
+			case DW_AT_data_member_location: id.member_location = a; break;
+			case DW_AT_location: id.location = a; break;
+			case DW_AT_frame_base: id.frame_base = a; break;
+		}
+	}
+
+	hasChild = id.hasChild != 0;
+	sibling = id.sibling;
+
+	return true;
+}
+
+bool DIECursor::skipNext()
+{
+	if (hasChild)
+		++level;
+
+	byte* end = cu->end();
+	if (level == -1 || ptr >= end)
+		return false;
+
+	sibling = 0;
+	unsigned code = LEB128(ptr, end);
+	if (code == 0)
+	{
+		--level;
+		hasChild = false;
+		return true;
+	}
+
+	const DWARF_Abbrev* abbrev = getAbbrev(cu->abbrevOffset(), code);
+	assert(abbrev);
+	if (!abbrev)
+		return false;
+
+	hasChild = abbrev->hasChild != 0;
+	if (abbrev->fixedSize >= 0)
+	{
+		ptr += abbrev->fixedSize + abbrev->numAddr * cu->addressSize() + abbrev->numOffset * cu->refSize();
+		return true;
+	}
+
+	byte* abbrevEnd = abbrevData.data() + abbrevData.size();
+	byte* spec = abbrev->attrs;
+	int attr, form, implicitConst;
+	while (readAttrSpec(spec, abbrevEnd, attr, form, implicitConst))
+	{
+		ptr = skipForm(cu, ptr, end, form);
+		if (!ptr)
+			return false;
+	}
+	return true;
+}
+
+bool DIECursor::readNext(DWARF_DIEView& die, bool stopAtNull)
+{
+	if (hasChild)
+		++level;
+
+	byte* end = cu->end();
+	for (;;)
+	{
+		if (level == -1)
+			return false;
+		if (ptr >= end)
+			return false;
+
+		die.entryPtr = ptr;
+		die.code = LEB128(ptr, end);
+		if (die.code == 0)
+		{
+			--level;
+			if (stopAtNull)
+			{
+				hasChild = false;
+				return false;
+			}
+			continue;
+		}
+		break;
+	}
+
+	countStat(kStatDIEs);
+	const DWARF_Abbrev* abbr = getAbbrev(cu->abbrevOffset(), die.code);
+	assert(abbr);
+	if (!abbr)
+		return false;
+
+	die.cu = cu;
+	die.tag = abbr->tag;
+	die.hasChild = abbr->hasChild;
+	die.attrs = abbr->attrs;
+	die.data = ptr;
+	hasChild = die.hasChild != 0;
+
+	// skip the attribute values, only the sibling is needed to navigate the tree
+	sibling = 0;
+	if (abbr->fixedSize >= 0 && !abbr->hasSibling)
+	{
+		ptr += abbr->fixedSize + abbr->numAddr * cu->addressSize() + abbr->numOffset * cu->refSize();
+		return true;
+	}
+
+	byte* abbrevEnd = abbrevData.data() + abbrevData.size();
+	byte* abbrev = abbr->attrs;
+	int attr, form, implicitConst;
+	while (readAttrSpec(abbrev, abbrevEnd, attr, form, implicitConst))
+	{
+		if (attr == DW_AT_sibling)
+		{
+			DWARF_Attribute a;
+			if (!readAttr(cu, ptr, end, form, implicitConst, a))
+				return false;
+			if (a.type == Ref)
+				sibling = a.ref;
+		}
+		else if (!(ptr = skipForm(cu, ptr, end, form)))
+			return false;
+	}
+	return true;
+}
+
+bool DWARF_DIEView::getAttr(int at, DWARF_Attribute& a) const
+{
+	byte* end = cu->end();
+	byte* abbrevEnd = abbrevData.data() + abbrevData.size();
+	byte* spec = attrs;
+	byte* ptr = data;
+	int attr, form, implicitConst;
+	while (readAttrSpec(spec, abbrevEnd, attr, form, implicitConst))
+	{
+		if (attr == at)
+			return readAttr(cu, ptr, end, form, implicitConst, a);
+		ptr = skipForm(cu, ptr, end, form);
+		if (!ptr)
+			return false;
+	}
+	return false;
+}
+
+long DWARF_DIEView::getConst(int at, long def) const
+{
+	DWARF_Attribute a;
+	if (getAttr(at, a) && a.type == Const)
+		return a.cons;
+	return def;
+}
+
+// classify the attribute values of an abbreviation by size
+static void classifyAbbrev(DWARF_Abbrev& abbrev, byte* p, byte* end)
+{
+	abbrev.ptr = p;
+	abbrev.tag = LEB128(p, end);
+	abbrev.hasChild = p < end ? *p++ : 0;
+	abbrev.attrs = p;
+	abbrev.hasSibling = false;
+	abbrev.fixedSize = 0;
+	abbrev.numAddr = 0;
+	abbrev.numOffset = 0;
+
+	int attr, form, implicitConst;
+	while (readAttrSpec(p, end, attr, form, implicitConst))
+	{
+		if (attr == DW_AT_sibling)
+			abbrev.hasSibling = true;
+
+		int size = constFormSize(form);
+		if (form == DW_FORM_addr)
+			abbrev.numAddr++;
+		else if (isOffsetForm(form))
+			abbrev.numOffset++;
+		else if (size < 0)
+			abbrev.fixedSize = -1;
+		else if (abbrev.fixedSize >= 0)
+			abbrev.fixedSize += size;
+
+		if (p >= end)
+			break; // truncated section, the attribute read last is still counted
+	}
+}
+
+const DWARF_Abbrev* DIECursor::getAbbrev(unsigned off, unsigned findcode)
+{
+	if (abbrevData.empty())
+		return 0;
+
+	std::pair<unsigned, unsigned> key = std::make_pair(off, findcode);
+	abbrevMap_t::iterator it = abbrevMap.find(key);
+	if (it != abbrevMap.end())
+	{
+		countStat(kStatAbbrevHits);
+		return &it->second;
+	}
+
+	countStat(kStatAbbrevMisses);
+	if (off >= abbrevData.size())
+		return 0;
+	byte* p = abbrevData.data() + off;
+	byte* end = abbrevData.data() + abbrevData.size();
+	while (p < end)
+	{
+		unsigned code = LEB128(p, end);
+		if (code == findcode)
+		{
+			DWARF_Abbrev& abbrev = abbrevMap[key];
+			classifyAbbrev(abbrev, p, end);
+			return &abbrev;
+		}
+		if (code == 0)
+			return 0;
+
+		LEB128(p, end); // tag
+		p++; // hasChild
+
+		// skip attributes
+		int attr, form, implicitConst;
+		while (readAttrSpec(p, end, attr, form, implicitConst) && p < end)
+			;
+	}
+	return 0;
+}
+
+byte* DIECursor::getDWARFAbbrev(unsigned off, unsigned findcode)
+{
+	const DWARF_Abbrev* abbrev = getAbbrev(off, findcode);
+	return abbrev ? abbrev->ptr : 0;
+}
+
+bool readDWARFRanges(DWARF_CompilationUnit* cu, unsigned long off, std::vector<DWARF_Range>& ranges)
+{
+	int addrSize = cu->addressSize();
+	unsigned long base = getUnitBases(cu).lowPC;
+	DWARF_Range range;
+	if (cu->version < 5)
+	{
+		if (!img->debug_ranges || off >= img->debug_ranges_length)
+			return false;
+		byte* r = (byte*)img->debug_ranges + off;
+		byte* rend = (byte*)img->debug_ranges + img->debug_ranges_length;
+		while (rend - r >= 2 * addrSize)
+		{
+			unsigned long long pclo = RDaddr(r, addrSize);
+			unsigned long long pchi = RDaddr(r, addrSize);
+			if (pclo == 0 && pchi == 0)
+				break;
+			if (pclo == (addrSize == 4 ? 0xffffffffULL : ~0ULL))
+				base = (unsigned long)pchi; // base address selection entry
+			else
+			{
+				range.pclo = base + (unsigned long)pclo;
+				range.pchi = base + (unsigned long)pchi;
+				ranges.push_back(range);
+			}
+		}
+		return true;
+	}
+
+	if (!img->debug_rnglists || off >= img->debug_rnglists_length)
+		return false;
+	byte* r = (byte*)img->debug_rnglists + off;
+	byte* rend = (byte*)img->debug_rnglists + img->debug_rnglists_length;
+	while (r < rend)
+	{
+		switch (*r++)
+		{
+			case DW_RLE_end_of_list:
+				return true;
+			case DW_RLE_base_addressx:
+				base = indexedAddr(cu, LEB128(r, rend));
+				continue;
+			case DW_RLE_startx_endx:
+				range.pclo = indexedAddr(cu, LEB128(r, rend));
+				range.pchi = indexedAddr(cu, LEB128(r, rend));
+				break;
+			case DW_RLE_startx_length:
+				range.pclo = indexedAddr(cu, LEB128(r, rend));
+				range.pchi = range.pclo + LEB128(r, rend);
+				break;
+			case DW_RLE_offset_pair:
+				range.pclo = base + LEB128(r, rend);
+				range.pchi = base + LEB128(r, rend);
+				break;
+			case DW_RLE_base_address:
+				if (rend - r < addrSize)
+					return true;
+				base = (unsigned long)RDaddr(r, addrSize);
+				continue;
+			case DW_RLE_start_end:
+				if (rend - r < 2 * addrSize)
+					return true;
+				range.pclo = (unsigned long)RDaddr(r, addrSize);
+				range.pchi = (unsigned long)RDaddr(r, addrSize);
+				break;
+			case DW_RLE_start_length:
+				if (rend - r < addrSize)
+					return true;
+				range.pclo = (unsigned long)RDaddr(r, addrSize);
+				range.pchi = range.pclo + LEB128(r, rend);
+				break;
+			default:
+				return true; // unknown entry, its size is unknown, too
+		}
+		ranges.push_back(range);
+	}
+	return true;
+}
+
+bool DWARF_LineNumberProgramHeader::read(byte* &p, byte* end)
+{
+	if (end - p < 6)
+		return false;
+	unit_length = RD4(p);
+	version = RD2(p);
+	if (unit_length == 0xffffffff || version < 2 || version > 5)
+		return false; // 64-bit DWARF or unknown layout
+
+	int fixedSize = 9 + (version >= 4 ? 1 : 0) + (version >= 5 ? 2 : 0);
+	if (end - p < fixedSize)
+		return false;
+	if (version >= 5)
+		p += 2; // address_size, segment_selector_size
+	header_length = RD4(p);
+	minimum_instruction_length = *p++;
+	if (version >= 4)
+		p++; // maximum_operations_per_instruction, only used for VLIW architectures
+	default_is_stmt = *p++;
+	line_base = (signed char) *p++;
+	line_range = *p++;
+	opcode_base = *p++;
+	return line_range != 0 && opcode_base != 0;
+}
@@ -1,370 +1,567 @@
-#ifndef __READDWARF_H__
-#define __READDWARF_H__
-
-#include <string>
-#include <vector>
-#include "mspdb.h"
-
-typedef unsigned char byte;
-
-inline unsigned int LEB128(byte* &p)
-{
-	unsigned int x = 0;
-	int shift = 0;
-	while (*p & 0x80)
-	{
-		x |= (*p & 0x7f) << shift;
-		shift += 7;
-		p++;
-	}
-	x |= *p << shift;
-	p++;
-	return x;
-}
-
-inline int SLEB128(byte* &p)
-{
-	unsigned int x = 0;
-	int shift = 0;
-	while (*p & 0x80)
-	{
-		x |= (*p & 0x7f) << shift;
-		shift += 7;
-		p++;
-	}
-	x |= *p << shift;
-	if (*p & 0x40)
-		x |= -(1 << (shift + 7)); // sign extend
-	p++;
-	return x;
-}
-
-inline unsigned int RD2(byte* &p)
-{
-	unsigned int x = *p++;
-	x |= *p++ << 8;
-	return x;
-}
-
-inline unsigned int RD4(byte* &p)
-{
-	unsigned int x = *p++;
-	x |= *p++ << 8;
-	x |= *p++ << 16;
-	x |= *p++ << 24;
-	return x;
-}
-
-inline unsigned long long RD8(byte* &p)
-{
-	unsigned long long x = *p++;
-	for (int shift = 8; shift < 64; shift += 8)
-		x |= (unsigned long long) *p++ << shift;
-	return x;
-}
-
-inline unsigned long long RDsize(byte* &p, int size)
-{
-	if (size > 8)
-		size = 8;
-	unsigned long long x = *p++;
-	for (int shift = 8; shift < size * 8; shift += 8)
-		x |= (unsigned long long) *p++ << shift;
-	return x;
-}
-
-enum AttrClass
-{
-	Invalid,
-	Addr,
-	Block,
-	Const,
-	String,
-	Flag,
-	Ref,
-	ExprLoc,
-	SecOffset
-};
-
-struct DWARF_Attribute
-{
-	AttrClass type;
-	union
-	{
-		unsigned long addr;
-		struct { byte* ptr; unsigned len; } block;
-		unsigned long cons;
-		const char* string;
-		bool flag;
-		byte* ref;
-		struct { byte* ptr; unsigned len; } expr;
-		unsigned long sec_offset;
-	};
-};
-
-///////////////////////////////////////////////////////////////////////////////
-
-#include "pshpack1.h"
-
-struct DWARF_CompilationUnit
-{
-	unsigned int unit_length; // 12 byte in DWARF-64
-	unsigned short version;
-	unsigned int debug_abbrev_offset; // 8 byte in DWARF-64
-	byte address_size;
-
-	bool isDWARF64() const { return unit_length == ~0; }
-	int refSize() const { return unit_length == ~0 ? 8 : 4; }
-};
-
-struct DWARF_FileName
-{
-	const char* file_name;
-	unsigned int  dir_index;
-	unsigned long lastModification;
-	unsigned long fileLength;
-
-	void read(byte* &p)
-	{
-		file_name = (const char*)p;
-		p += strlen((const char*)p) + 1;
-		dir_index = LEB128(p);
-		lastModification = LEB128(p);
-		fileLength = LEB128(p);
-	}
-};
-
-struct DWARF_InfoData
-{
-	byte* entryPtr;
-	unsigned entryOff; // offset in the cu
-	int code;
-	byte* abbrev;
-	int tag;
-	int hasChild;
-
-	const char* name;
-	const char* linkage_name;
-	const char* dir;
-	unsigned long byte_size;
-	byte* sibling;
-	unsigned long encoding;
-	unsigned long pclo;
-	unsigned long pchi;
-	unsigned long ranges;
-	byte* type;
-	byte* containing_type;
-	byte* specification;
-	unsigned long inlined;
-	bool external;
-	DWARF_Attribute location;
-	DWARF_Attribute member_location;
-	DWARF_Attribute frame_base;
-	long upper_bound;
-	long lower_bound;
-
-	void clear()
-	{
-		entryPtr = 0;
-		code = 0;
-		abbrev = 0;
-		tag = 0;
-		hasChild = 0;
-
-		name = 0;
-		linkage_name = 0;
-		dir = 0;
-		byte_size = 0;
-		sibling = 0;
-		encoding = 0;
-		pclo = 0;
-		pchi = 0;
-		ranges = -1;
-		type = 0;
-		containing_type = 0;
-		specification = 0;
-		inlined = 0;
-		external = 0;
-		member_location.type = Invalid;
-		location.type = Invalid;
-		frame_base.type = Invalid;
-		upper_bound = 0;
-		lower_bound = 0;
-	}
-
-	void merge(const DWARF_InfoData& id)
-	{
-		if (id.name) name = id.name;
-		if (id.linkage_name) linkage_name = id.linkage_name;
-		if (id.dir) dir = id.dir;
-		if (id.byte_size) byte_size = id.byte_size;
-		if (id.sibling) sibling = id.sibling;
-		if (id.encoding) encoding = id.encoding;
-		if (id.pclo) pclo = id.pclo;
-		if (id.pchi) pchi = id.pchi;
-		if (id.ranges != -1) ranges = id.ranges;
-		if (id.type) type = id.type;
-		if (id.containing_type) containing_type = id.containing_type;
-		if (id.specification) specification = id.specification;
-		if (id.inlined) inlined = id.inlined;
-		if (id.external) external = id.external;
-		if (id.member_location.type != Invalid) member_location = id.member_location;
-		if (id.location.type != Invalid) location = id.location;
-		if (id.frame_base.type != Invalid) frame_base = id.frame_base;
-		if (id.upper_bound) upper_bound = id.upper_bound;
-		if (id.lower_bound) lower_bound = id.lower_bound;
-	}
-};
-
-static const int maximum_operations_per_instruction = 1;
-
-struct DWARF_LineNumberProgramHeader
-{
-	unsigned int unit_length; // 12 byte in DWARF-64
-	unsigned short version;
-	unsigned int header_length; // 8 byte in DWARF-64
-	byte minimum_instruction_length;
-	//byte maximum_operations_per_instruction; (// not in DWARF 2
-	byte default_is_stmt;
-	signed char line_base;
-	byte line_range;
-	byte opcode_base;
-	//LEB128 standard_opcode_lengths[opcode_base]; 
-	// string include_directories[] // zero byte terminated
-	// DWARF_FileNames file_names[] // zero byte terminated
-};
-
-struct DWARF_LineState
-{
-	// hdr info
-	std::vector<const char*> include_dirs;
-	std::vector<DWARF_FileName> files;
-
-	unsigned long address;
-	unsigned int  op_index;
-	unsigned int  file;
-	unsigned int  line;
-	unsigned int  column;
-	bool          is_stmt;
-	bool          basic_block;
-	bool          end_sequence;
-	bool          prologue_end;
-	bool          epilogue_end;
-	unsigned int  isa;
-	unsigned int  discriminator;
-
-	// not part of the "documented" state
-	DWARF_FileName* file_ptr;
-	unsigned long seg_offset;
-	unsigned long last_addr;
-	std::vector<mspdb::LineInfoEntry> lineInfo;
-
-	DWARF_LineState()
-	{
-		seg_offset = 0x400000;
-		init(0);
-	}
-
-	void init(DWARF_LineNumberProgramHeader* hdr)
-	{
-		address = 0;
-		op_index = 0;
-		file = 1;
-		line = 1;
-		column = 0;
-		is_stmt = hdr && hdr->default_is_stmt != 0;
-		basic_block = false;
-		end_sequence = false;
-		prologue_end = false;
-		epilogue_end = false;
-		isa = 0;
-		discriminator = 0;
-	}
-
-	void advance_addr(DWARF_LineNumberProgramHeader* hdr, int operation_advance)
-	{
-		int address_advance = hdr->minimum_instruction_length * ((op_index + operation_advance) / maximum_operations_per_instruction);
-		address += address_advance;
-		op_index = (op_index + operation_advance) % maximum_operations_per_instruction;
-	}
-
-	void addLineInfo()
-	{
-#if 0
-		const char* fname = (file == 0 ? file_ptr->file_name : files[file - 1].file_name);
-		printf("Adr:%08x Line: %5d File: %s\n", address, line, fname);
-#endif
-		if (address < seg_offset)
-			return;
-		mspdb::LineInfoEntry entry;
-		entry.offset = address - seg_offset;
-		entry.line = line;
-		lineInfo.push_back(entry);
-	}
-};
-
-#include "poppack.h"
-
-///////////////////////////////////////////////////////////////////////////////
-
-
-struct Location
-{
-	enum Type
-	{
-		Invalid, // Failed to evaluate the location expression
-		InReg,   // In register (reg)
-		Abs,     // Absolute address (off)
-		RegRel   // Register-relative address ($reg + off)
-	};
-
-	Type type;
-	int reg;
-	int off;
-
-	bool is_invalid() const { return type == Invalid; }
-	bool is_inreg() const { return type == InReg; }
-	bool is_abs() const { return type == Abs; }
-	bool is_regrel() const { return type == RegRel; }
-};
-
-// Attemots to partially evaluate DWARF location expressions.
-// The only supported expressions are those, whose result may be represented
-// as either an absolute value, a register, or a register-relative address.
-Location decodeLocation(const DWARF_Attribute& attr, const Location* frameBase = 0);
-
-class PEImage;
-
-// Debug Information Entry Cursor
-class DIECursor
-{
-public:
-	DWARF_CompilationUnit* cu;
-	byte* ptr;
-	int level;
-	bool hasChild; // indicates whether the last read DIE has children
-	byte* sibling;
-
-	byte* getDWARFAbbrev(unsigned off, unsigned findcode);
-
-public:
-
-	static void setContext(PEImage* img_);
-
-	// Create a new DIECursor
-	DIECursor(DWARF_CompilationUnit* cu_, byte* ptr);
-
-	// Reads next sibling DIE.  If the last read DIE had any children, they will be skipped over.
-	// Returns 'false' upon reaching the last sibling on the current level.
-	bool readSibling(DWARF_InfoData& id);
-
-	// Returns cursor that will enumerate children of the last read DIE.
-	DIECursor getSubtreeCursor();
-
-	// Reads the next DIE in physical order, returns 'true' if succeeds.
-	// If stopAtNull is true, readNext() will stop upon reaching a null DIE (end of the current tree level).
-	// Otherwise, it will skip null DIEs and stop only at the end of the subtree for which this DIECursor was created.
-	bool readNext(DWARF_InfoData& id, bool stopAtNull = false);
-};
-
+#ifndef __READDWARF_H__
+#define __READDWARF_H__
+
+#include <string>
+#include <vector>
+#include <string.h>
+#include "mspdb.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+typedef unsigned char byte;
+
+inline unsigned int LEB128(byte* &p)
+{
+	unsigned int x = 0;
+	int shift = 0;
+	while (*p & 0x80)
+	{
+		x |= (*p & 0x7f) << shift;
+		shift += 7;
+		p++;
+	}
+	x |= *p << shift;
+	p++;
+	return x;
+}
+
+inline int SLEB128(byte* &p)
+{
+	unsigned int x = 0;
+	int shift = 0;
+	while (*p & 0x80)
+	{
+		x |= (*p & 0x7f) << shift;
+		shift += 7;
+		p++;
+	}
+	x |= *p << shift;
+	if (*p & 0x40)
+		x |= -(1 << (shift + 7)); // sign extend
+	p++;
+	return x;
+}
+
+inline int ctz64(unsigned long long x)
+{
+#ifdef _MSC_VER
+	unsigned long idx;
+	if (_BitScanForward(&idx, (unsigned long) x))
+		return idx;
+	_BitScanForward(&idx, (unsigned long) (x >> 32));
+	return idx + 32;
+#else
+	return __builtin_ctzll(x);
+#endif
+}
+
+// LEB128 decoding that never reads at or beyond end. On truncated data
+// the partial value is returned and p is set to end.
+inline unsigned int LEB128(byte* &p, const byte* end)
+{
+	if (end - p >= 10)
+	{
+		// no checks needed for up to 10 bytes, the longest encoding of a 64-bit value
+		unsigned int b0 = p[0];
+		if (!(b0 & 0x80))
+		{
+			p++;
+			return b0;
+		}
+		unsigned int b1 = p[1];
+		if (!(b1 & 0x80))
+		{
+			p += 2;
+			return (b0 & 0x7f) | (b1 << 7);
+		}
+
+		// load 8 bytes (little endian), the first byte without continuation bit ends the value
+		unsigned long long w;
+		memcpy(&w, p, sizeof(w));
+		unsigned long long stop = ~w & 0x8080808080808080ULL;
+		if (stop)
+		{
+			w &= stop ^ (stop - 1);
+			p += (ctz64(stop) >> 3) + 1;
+			return (unsigned int) ((w & 0x7f) | ((w >> 1) & 0x3f80) | ((w >> 2) & 0x1fc000) |
+			                       ((w >> 3) & 0xfe00000) | ((w >> 4) & 0x7f0000000ULL));
+		}
+	}
+
+	// close to the end of the data or overlong encoding
+	unsigned int x = 0;
+	for (int shift = 0; p < end; shift += 7)
+	{
+		unsigned int b = *p++;
+		if (shift < 32)
+			x |= (b & 0x7f) << shift;
+		if (!(b & 0x80))
+			break;
+	}
+	return x;
+}
+
+inline int SLEB128(byte* &p, const byte* end)
+{
+	byte* q = p;
+	unsigned int x = LEB128(p, end);
+	int bits = 7 * (p - q);
+	if (bits > 0 && bits < 32 && (p[-1] & 0x40))
+		x |= ~0U << bits; // sign extend
+	return x;
+}
+
+inline unsigned int RD2(byte* &p)
+{
+	unsigned int x = *p++;
+	x |= *p++ << 8;
+	return x;
+}
+
+inline unsigned int RD4(byte* &p)
+{
+	unsigned int x = *p++;
+	x |= *p++ << 8;
+	x |= *p++ << 16;
+	x |= *p++ << 24;
+	return x;
+}
+
+inline unsigned long long RD8(byte* &p)
+{
+	unsigned long long x = *p++;
+	for (int shift = 8; shift < 64; shift += 8)
+		x |= (unsigned long long) *p++ << shift;
+	return x;
+}
+
+inline unsigned long long RDsize(byte* &p, int size)
+{
+	if (size > 8)
+		size = 8;
+	unsigned long long x = *p++;
+	for (int shift = 8; shift < size * 8; shift += 8)
+		x |= (unsigned long long) *p++ << shift;
+	return x;
+}
+
+// read little endian value of size known at compile time
+template<int N> inline unsigned long long RDfixed(byte* &p)
+{
+	return RDsize(p, N);
+}
+
+template<> inline unsigned long long RDfixed<1>(byte* &p)
+{
+	return *p++;
+}
+
+template<> inline unsigned long long RDfixed<2>(byte* &p)
+{
+	unsigned short x;
+	memcpy(&x, p, sizeof(x));
+	p += sizeof(x);
+	return x;
+}
+
+template<> inline unsigned long long RDfixed<4>(byte* &p)
+{
+	unsigned int x;
+	memcpy(&x, p, sizeof(x));
+	p += sizeof(x);
+	return x;
+}
+
+template<> inline unsigned long long RDfixed<8>(byte* &p)
+{
+	unsigned long long x;
+	memcpy(&x, p, sizeof(x));
+	p += sizeof(x);
+	return x;
+}
+
+// read target address, dispatching to the fixed size readers
+inline unsigned long long RDaddr(byte* &p, int size)
+{
+	if (size == 4)
+		return RDfixed<4>(p);
+	if (size == 8)
+		return RDfixed<8>(p);
+	return RDsize(p, size);
+}
+
+enum AttrClass
+{
+	Invalid,
+	Addr,
+	Block,
+	Const,
+	String,
+	Flag,
+	Ref,
+	ExprLoc,
+	SecOffset
+};
+
+struct DWARF_Attribute
+{
+	AttrClass type;
+	union
+	{
+		unsigned long addr;
+		struct { byte* ptr; unsigned len; } block;
+		unsigned long cons;
+		const char* string;
+		bool flag;
+		byte* ref;
+		struct { byte* ptr; unsigned len; byte addrSize; unsigned addrBase; } expr; // of the CU for DW_OP_addr and DW_OP_addrx
+		unsigned long sec_offset;
+	};
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma pack(push, 1)
+
+struct DWARF_CompilationUnit
+{
+	unsigned int unit_length; // 12 byte in DWARF-64
+	unsigned short version;
+	// DWARF 2 to 4: debug_abbrev_offset (4 byte), address_size
+	// DWARF 5: unit_type, address_size, debug_abbrev_offset (4 byte)
+	byte fields[6];
+
+	bool isDWARF64() const { return unit_length == 0xffffffff; }
+	int refSize() const { return unit_length == 0xffffffff ? 8 : 4; }
+
+	byte addressSize() const { return version >= 5 ? fields[1] : fields[4]; }
+	unsigned int abbrevOffset() const
+	{
+		unsigned int off;
+		memcpy(&off, version >= 5 ? fields + 2 : fields, sizeof(off));
+		return off;
+	}
+	// DW_UT_compile or DW_UT_partial, type and split units are not converted
+	bool isCompileUnit() const { return version < 5 || fields[0] == 1 || fields[0] == 3; }
+
+	byte* firstDIE() { return fields + (version >= 5 ? 6 : 5); }
+	byte* end() { return (byte*)this + sizeof(unit_length) + unit_length; }
+};
+
+struct DWARF_FileName
+{
+	const char* file_name;
+	unsigned int  dir_index;
+	unsigned long lastModification;
+	unsigned long fileLength;
+
+	void read(byte* &p)
+	{
+		file_name = (const char*)p;
+		p += strlen((const char*)p) + 1;
+		dir_index = LEB128(p);
+		lastModification = LEB128(p);
+		fileLength = LEB128(p);
+	}
+};
+
+struct DWARF_InfoData
+{
+	byte* entryPtr;
+	unsigned entryOff; // offset in the cu
+	int code;
+	byte* abbrev;
+	int tag;
+	int hasChild;
+
+	const char* name;
+	const char* linkage_name;
+	const char* dir;
+	unsigned long byte_size;
+	byte* sibling;
+	unsigned long encoding;
+	unsigned long pclo;
+	unsigned long pchi;
+	unsigned long ranges;
+	byte* type;
+	byte* containing_type;
+	byte* specification;
+	unsigned long inlined;
+	bool external;
+	DWARF_Attribute location;
+	DWARF_Attribute member_location;
+	DWARF_Attribute frame_base;
+	long upper_bound;
+	long lower_bound;
+
+	void clear()
+	{
+		entryPtr = 0;
+		code = 0;
+		abbrev = 0;
+		tag = 0;
+		hasChild = 0;
+
+		name = 0;
+		linkage_name = 0;
+		dir = 0;
+		byte_size = 0;
+		sibling = 0;
+		encoding = 0;
+		pclo = 0;
+		pchi = 0;
+		ranges = -1;
+		type = 0;
+		containing_type = 0;
+		specification = 0;
+		inlined = 0;
+		external = 0;
+		member_location.type = Invalid;
+		location.type = Invalid;
+		frame_base.type = Invalid;
+		upper_bound = 0;
+		lower_bound = 0;
+	}
+
+	void merge(const DWARF_InfoData& id)
+	{
+		if (id.name) name = id.name;
+		if (id.linkage_name) linkage_name = id.linkage_name;
+		if (id.dir) dir = id.dir;
+		if (id.byte_size) byte_size = id.byte_size;
+		if (id.sibling) sibling = id.sibling;
+		if (id.encoding) encoding = id.encoding;
+		if (id.pclo) pclo = id.pclo;
+		if (id.pchi) pchi = id.pchi;
+		if (id.ranges != ~0UL) ranges = id.ranges;
+		if (id.type) type = id.type;
+		if (id.containing_type) containing_type = id.containing_type;
+		if (id.specification) specification = id.specification;
+		if (id.inlined) inlined = id.inlined;
+		if (id.external) external = id.external;
+		if (id.member_location.type != Invalid) member_location = id.member_location;
+		if (id.location.type != Invalid) location = id.location;
+		if (id.frame_base.type != Invalid) frame_base = id.frame_base;
+		if (id.upper_bound) upper_bound = id.upper_bound;
+		if (id.lower_bound) lower_bound = id.lower_bound;
+	}
+};
+
+// Lightweight view of a DIE: only the tag and the children flag are decoded,
+// attribute values are decoded on request by walking the abbreviation
+struct DWARF_DIEView
+{
+	DWARF_CompilationUnit* cu;
+	byte* entryPtr;
+	byte* data;  // attribute values
+	byte* attrs; // attribute specifications in the abbreviation
+	int code;
+	int tag;
+	int hasChild;
+
+	// returns false if the DIE does not have the attribute
+	bool getAttr(int at, DWARF_Attribute& a) const;
+	long getConst(int at, long def = 0) const;
+};
+
+static const int maximum_operations_per_instruction = 1;
+
+// decoded fixed part of the header, the layout depends on the version
+struct DWARF_LineNumberProgramHeader
+{
+	unsigned int unit_length; // 12 byte in DWARF-64
+	unsigned short version;
+	//byte address_size; // DWARF 5
+	//byte segment_selector_size; // DWARF 5
+	unsigned int header_length; // 8 byte in DWARF-64
+	byte minimum_instruction_length;
+	//byte maximum_operations_per_instruction; // DWARF 4
+	byte default_is_stmt;
+	signed char line_base;
+	byte line_range;
+	byte opcode_base;
+	//LEB128 standard_opcode_lengths[opcode_base]; 
+	// before DWARF 5:
+	// string include_directories[] // zero byte terminated
+	// DWARF_FileNames file_names[] // zero byte terminated
+	// DWARF 5: format and count of the directory and file name entries, the entries
+
+	// decode the fields, p is moved to the opcode lengths
+	bool read(byte* &p, byte* end);
+};
+
+struct DWARF_LineState
+{
+	// hdr info
+	std::vector<const char*> include_dirs;
+	std::vector<DWARF_FileName> files;
+	unsigned int  first_index; // number of include_dirs[0] and files[0], 0 since DWARF 5
+
+	unsigned long address;
+	unsigned int  op_index;
+	unsigned int  file;
+	unsigned int  line;
+	unsigned int  column;
+	bool          is_stmt;
+	bool          basic_block;
+	bool          end_sequence;
+	bool          prologue_end;
+	bool          epilogue_end;
+	unsigned int  isa;
+	unsigned int  discriminator;
+
+	// not part of the "documented" state
+	DWARF_FileName* file_ptr;
+	unsigned long seg_offset;
+	unsigned long last_addr;
+	std::vector<mspdb::LineInfoEntry> lineInfo;
+
+	DWARF_LineState()
+	{
+		first_index = 1;
+		seg_offset = 0x400000;
+		init(0);
+	}
+
+	void init(DWARF_LineNumberProgramHeader* hdr)
+	{
+		address = 0;
+		op_index = 0;
+		file = 1;
+		line = 1;
+		column = 0;
+		is_stmt = hdr && hdr->default_is_stmt != 0;
+		basic_block = false;
+		end_sequence = false;
+		prologue_end = false;
+		epilogue_end = false;
+		isa = 0;
+		discriminator = 0;
+	}
+
+	void advance_addr(DWARF_LineNumberProgramHeader* hdr, int operation_advance)
+	{
+		int address_advance = hdr->minimum_instruction_length * ((op_index + operation_advance) / maximum_operations_per_instruction);
+		address += address_advance;
+		op_index = (op_index + operation_advance) % maximum_operations_per_instruction;
+	}
+
+	void addLineInfo()
+	{
+#if 0
+		const char* fname = (file == 0 ? file_ptr->file_name : files[file - 1].file_name);
+		printf("Adr:%08x Line: %5d File: %s\n", address, line, fname);
+#endif
+		if (address < seg_offset)
+			return;
+		mspdb::LineInfoEntry entry;
+		entry.offset = address - seg_offset;
+		entry.line = line;
+		lineInfo.push_back(entry);
+	}
+};
+
+#pragma pack(pop)
+
+///////////////////////////////////////////////////////////////////////////////
+
+
+struct Location
+{
+	enum Type
+	{
+		Invalid, // Failed to evaluate the location expression
+		InReg,   // In register (reg)
+		Abs,     // Absolute address (off)
+		RegRel   // Register-relative address ($reg + off)
+	};
+
+	Type type;
+	int reg;
+	int off;
+
+	bool is_invalid() const { return type == Invalid; }
+	bool is_inreg() const { return type == InReg; }
+	bool is_abs() const { return type == Abs; }
+	bool is_regrel() const { return type == RegRel; }
+};
+
+// Attemots to partially evaluate DWARF location expressions.
+// The only supported expressions are those, whose result may be represented
+// as either an absolute value, a register, or a register-relative address.
+Location decodeLocation(const DWARF_Attribute& attr, const Location* frameBase = 0);
+
+class PEImage;
+
+// Abbreviation declaration, classified when first looked up to skip DIEs without decoding them
+struct DWARF_Abbrev
+{
+	byte* ptr;      // tag, children flag and attribute specifications
+	byte* attrs;    // attribute specifications
+	int tag;
+	int hasChild;
+	bool hasSibling;
+	int fixedSize;  // size of the attribute values excluding address and offset forms, -1 if variable
+	int numAddr;    // number of values with the address size of the CU
+	int numOffset;  // number of values with the offset size of the CU
+};
+
+// Debug Information Entry Cursor
+class DIECursor
+{
+public:
+	DWARF_CompilationUnit* cu;
+	byte* ptr;
+	int level;
+	bool hasChild; // indicates whether the last read DIE has children
+	byte* sibling;
+
+	static byte* getDWARFAbbrev(unsigned off, unsigned findcode);
+	static const DWARF_Abbrev* getAbbrev(unsigned off, unsigned findcode);
+
+	// advance over the next DIE in physical order without decoding its attributes
+	bool skipNext();
+
+	// readNext specialized for the address and offset size of the CU, selected by the constructor
+	bool (DIECursor::*readNextImpl)(DWARF_InfoData& id, bool stopAtNull);
+	template<int AddrSize, int OffSize> bool readNextT(DWARF_InfoData& id, bool stopAtNull);
+
+public:
+
+	static void setContext(PEImage* img_);
+	// drop the cached abbreviations if they take more than about maxBytes
+	static void limitAbbrevCache(size_t maxBytes);
+
+	// Create a new DIECursor
+	DIECursor(DWARF_CompilationUnit* cu_, byte* ptr);
+
+	// Reads next sibling DIE.  If the last read DIE had any children, they will be skipped over.
+	// Returns 'false' upon reaching the last sibling on the current level.
+	bool readSibling(DWARF_InfoData& id);
+	bool readSibling(DWARF_DIEView& die);
+
+	// Returns cursor that will enumerate children of the last read DIE.
+	DIECursor getSubtreeCursor();
+
+	// Reads the next DIE in physical order, returns 'true' if succeeds.
+	// If stopAtNull is true, readNext() will stop upon reaching a null DIE (end of the current tree level).
+	// Otherwise, it will skip null DIEs and stop only at the end of the subtree for which this DIECursor was created.
+	bool readNext(DWARF_InfoData& id, bool stopAtNull = false) { return (this->*readNextImpl)(id, stopAtNull); }
+
+	// Same as above, but attributes are skipped without decoding, use DWARF_DIEView::getAttr() to read them.
+	bool readNext(DWARF_DIEView& die, bool stopAtNull = false);
+};
+
+struct DWARF_Range
+{
+	unsigned long pclo;
+	unsigned long pchi;
+};
+
+// read the address ranges at off in .debug_ranges or, since DWARF 5, in .debug_rnglists
+// of the image passed to DIECursor::setContext. Returns false if off is out of range.
+bool readDWARFRanges(DWARF_CompilationUnit* cu, unsigned long off, std::vector<DWARF_Range>& ranges);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,215 @@
+// Convert DMD CodeView/DWARF debug information to PDB files
+// Copyright (c) 2009-2012 by Rainer Schuetze, All Rights Reserved
+//
+// License for redistribution is given by the Artistic License 2.0
+// see file LICENSE for further details
+
+#include "stats.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <time.h>
+#include <sys/resource.h>
+#endif
+#include <stdio.h>
+#include <string.h>
+#include <map>
+#include <vector>
+
+unsigned long long statCounters[kNumStatCounters];
+
+static const char* const statCounterNames[kNumStatCounters] =
+{
+	"dies",
+	"abbrev_hits",
+	"abbrev_misses",
+	"locations",
+	"locations_evaluated",
+	"types",
+	"symbols",
+	"publics",
+	"line_entries",
+	"addlines_calls",
+	"addsymbols_calls",
+	"bytes_addtypes",
+	"bytes_addsymbols",
+	"bytes_addlines",
+	"bytes_decompressed",
+};
+
+static std::map<unsigned int, unsigned long long> typesByLeaf;
+
+struct Phase
+{
+	const char* name;
+	int depth;
+	bool ok;
+	double wall; // seconds
+	double cpu;
+};
+
+static std::vector<Phase> phases;
+static std::vector<int> openPhases; // index into phases
+static std::vector<double> phaseStartWall;
+static std::vector<double> phaseStartCpu;
+
+#ifdef _WIN32
+static double wallTime()
+{
+	LARGE_INTEGER freq, cnt;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&cnt);
+	return (double) cnt.QuadPart / freq.QuadPart;
+}
+
+static double cpuTime()
+{
+	FILETIME creation, exit, kernel, user;
+	if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+		return 0;
+	unsigned long long k = ((unsigned long long) kernel.dwHighDateTime << 32) | kernel.dwLowDateTime;
+	unsigned long long u = ((unsigned long long) user.dwHighDateTime << 32) | user.dwLowDateTime;
+	return (k + u) * 1e-7;
+}
+#else
+static double wallTime()
+{
+	timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static double cpuTime()
+{
+	timespec t;
+	if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &t) != 0)
+		return 0;
+	return t.tv_sec + t.tv_nsec * 1e-9;
+}
+#endif
+
+void countStatTypes(const unsigned char* types, int cb)
+{
+	countStat(kStatBytesAddTypes, cb);
+	for (int off = 4; off + 4 <= cb; )
+	{
+		unsigned int len = *(const unsigned short*)(types + off);
+		unsigned int leaf = *(const unsigned short*)(types + off + 2);
+		typesByLeaf[leaf]++;
+		countStat(kStatTypes);
+		off += len + 2;
+	}
+}
+
+void countStatSymbols(const unsigned char* symbols, int cb)
+{
+	for (int off = 0; off + 2 <= cb; )
+	{
+		unsigned int len = *(const unsigned short*)(symbols + off);
+		countStat(kStatSymbols);
+		off += len + 2;
+	}
+}
+
+void beginPhase(const char* name)
+{
+	Phase ph = { name, (int) openPhases.size(), false, 0, 0 };
+	openPhases.push_back(phases.size());
+	phases.push_back(ph);
+	phaseStartCpu.push_back(cpuTime());
+	phaseStartWall.push_back(wallTime());
+}
+
+bool endPhase(bool result)
+{
+	if (openPhases.empty())
+		return result;
+
+	Phase& ph = phases[openPhases.back()];
+	ph.wall = wallTime() - phaseStartWall.back();
+	ph.cpu = cpuTime() - phaseStartCpu.back();
+	ph.ok = result;
+
+	openPhases.pop_back();
+	phaseStartWall.pop_back();
+	phaseStartCpu.pop_back();
+	return result;
+}
+
+void resetStats()
+{
+	memset(statCounters, 0, sizeof(statCounters));
+	typesByLeaf.clear();
+	phases.clear();
+	openPhases.clear();
+	phaseStartWall.clear();
+	phaseStartCpu.clear();
+}
+
+static unsigned long long peakMemory()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS pmc;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+		return 0;
+	return pmc.PeakWorkingSetSize;
+#else
+	struct rusage ru;
+	if (getrusage(RUSAGE_SELF, &ru) != 0)
+		return 0;
+	return (unsigned long long) ru.ru_maxrss * 1024; // kilobytes on Linux
+#endif
+}
+
+void printStats(bool json)
+{
+	// close phases left open by a failing conversion
+	while (!openPhases.empty())
+		endPhase(false);
+
+	// throughput relative to the time of all top level phases
+	double total = 0;
+	for (size_t i = 0; i < phases.size(); i++)
+		if (phases[i].depth == 0)
+			total += phases[i].wall;
+	double diesPerSec = total > 0 ? statCounters[kStatDIEs] / total : 0;
+	double typesPerSec = total > 0 ? statCounters[kStatTypes] / total : 0;
+	double linesPerSec = total > 0 ? statCounters[kStatLineEntries] / total : 0;
+
+	if (json)
+	{
+		printf("{\"phases\":[");
+		for (size_t i = 0; i < phases.size(); i++)
+			printf("%s{\"name\":\"%s\",\"depth\":%d,\"ok\":%s,\"wall\":%.6f,\"cpu\":%.6f}",
+			       i ? "," : "", phases[i].name, phases[i].depth, phases[i].ok ? "true" : "false",
+			       phases[i].wall, phases[i].cpu);
+		printf("],\"counters\":{");
+		for (int c = 0; c < kNumStatCounters; c++)
+			printf("%s\"%s\":%llu", c ? "," : "", statCounterNames[c], statCounters[c]);
+		printf("},\"types_by_leaf\":{");
+		for (std::map<unsigned int, unsigned long long>::iterator it = typesByLeaf.begin(); it != typesByLeaf.end(); ++it)
+			printf("%s\"0x%04x\":%llu", it == typesByLeaf.begin() ? "" : ",", it->first, it->second);
+		printf("},\"rates\":{\"dies_per_sec\":%.0f,\"types_per_sec\":%.0f,\"lines_per_sec\":%.0f}",
+		       diesPerSec, typesPerSec, linesPerSec);
+		printf(",\"peak_rss\":%llu}\n", peakMemory());
+	}
+	else
+	{
+		printf("%-32s %10s %10s\n", "phase", "wall [ms]", "cpu [ms]");
+		for (size_t i = 0; i < phases.size(); i++)
+			printf("%*s%-*s %10.3f %10.3f%s\n", 2 * phases[i].depth, "", 32 - 2 * phases[i].depth, phases[i].name,
+			       phases[i].wall * 1000, phases[i].cpu * 1000, phases[i].ok ? "" : " (failed)");
+		printf("\n");
+		for (int c = 0; c < kNumStatCounters; c++)
+			printf("%-32s %10llu\n", statCounterNames[c], statCounters[c]);
+		for (std::map<unsigned int, unsigned long long>::iterator it = typesByLeaf.begin(); it != typesByLeaf.end(); ++it)
+			printf("  leaf 0x%04x%19s %10llu\n", it->first, "", it->second);
+		printf("%-32s %10.0f\n", "dies_per_sec", diesPerSec);
+		printf("%-32s %10.0f\n", "types_per_sec", typesPerSec);
+		printf("%-32s %10.0f\n", "lines_per_sec", linesPerSec);
+		printf("%-32s %10llu\n", "peak_rss", peakMemory());
+	}
+}
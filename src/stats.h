@@ -0,0 +1,54 @@
+// Convert DMD CodeView/DWARF debug information to PDB files
+// Copyright (c) 2009-2012 by Rainer Schuetze, All Rights Reserved
+//
+// License for redistribution is given by the Artistic License 2.0
+// see file LICENSE for further details
+
+#ifndef __STATS_H__
+#define __STATS_H__
+
+// counters and phase timings of a conversion, reported with option --stats
+
+enum StatCounter
+{
+	kStatDIEs,
+	kStatAbbrevHits,
+	kStatAbbrevMisses,
+	kStatLocations,
+	kStatLocationsEvaluated,
+	kStatTypes,
+	kStatSymbols,
+	kStatPublics,
+	kStatLineEntries,
+	kStatAddLines,
+	kStatAddSymbols,
+	kStatBytesAddTypes,
+	kStatBytesAddSymbols,
+	kStatBytesAddLines,
+	kStatBytesDecompressed,
+	kNumStatCounters
+};
+
+extern unsigned long long statCounters[kNumStatCounters];
+
+inline void countStat(StatCounter c, unsigned long long n = 1)
+{
+	statCounters[c] += n;
+}
+
+// tally CodeView type records by leaf kind, types start with the 4 byte signature
+void countStatTypes(const unsigned char* types, int cb);
+// tally CodeView symbol records, without the header
+void countStatSymbols(const unsigned char* symbols, int cb);
+
+// phases can be nested, times are inclusive
+void beginPhase(const char* name);
+bool endPhase(bool result);
+
+// evaluate expression as named phase
+#define STAT_PHASE(name, expr) (beginPhase(name), endPhase(expr))
+
+void resetStats();
+void printStats(bool json);
+
+#endif //__STATS_H__
@@ -0,0 +1,1064 @@
+// Convert DMD CodeView/DWARF debug information to PDB files
+// Copyright (c) 2009-2012 by Rainer Schuetze, All Rights Reserved
+//
+// License for redistribution is given by the Artistic License 2.0
+// see file LICENSE for further details
+
+// regression tests of the image loader and the DWARF conversion on
+// synthetic images built in memory. No PDB file is written, so the tests
+// also run on build machines without the PDB helper DLL.
+
+#include "../src/cv2pdb.h"
+#include "../src/PEImage.h"
+#include "../src/readDwarf.h"
+#include "../src/inflate.h"
+#include "../src/pdbfile.h"
+#include "../src/dwarf.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef std::vector<unsigned char> Buffer;
+
+#ifndef _WIN32
+// the converter calls into the PDB helper DLL only when writing the PDB
+namespace mspdb {
+int vsVersion = 8;
+long PDB_part1::QueryLastError(char * const lastErr) { *lastErr = 0; return 0; }
+unsigned long PDB_part1::QueryAge() { return 0; }
+int PDB_part1::CreateDBI(char const *, struct DBI **) { return 0; }
+int PDB_part1::OpenTpi(char const *, struct TPI **) { return 0; }
+template<class BASE> int PDB_part2<BASE>::Commit() { return 0; }
+template<class BASE> int PDB_part2<BASE>::Close() { return 0; }
+template<class BASE> int PDB_part2<BASE>::QuerySignature2(struct _GUID *) { return 0; }
+template int PDB_part2<PDB_part1>::Commit();
+template int PDB_part2<PDB_part1>::Close();
+template int PDB_part2<PDB_part1>::QuerySignature2(struct _GUID *);
+int DBI_part1::OpenMod(char const *, char const *, struct Mod **) { return 0; }
+int DBI_part1::AddSec(unsigned short, unsigned short, long, long) { return 0; }
+int DBI_part1::Close() { return 0; }
+template<class BASE> int DBI_BASE<BASE>::AddPublic2(char const *, unsigned short, long, unsigned long) { return 0; }
+template<class BASE> void DBI_BASE<BASE>::SetMachineType(unsigned short) {}
+template int DBI_BASE<DBI_part1>::AddPublic2(char const *, unsigned short, long, unsigned long);
+template void DBI_BASE<DBI_part1>::SetMachineType(unsigned short);
+} // namespace mspdb
+
+bool initMsPdb() { return false; }
+mspdb::PDB* CreatePDB(const wchar_t*) { return 0; }
+#endif
+
+static int failures;
+
+static void check(bool ok, const char* test, const char* what)
+{
+	if (!ok)
+	{
+		printf("%s: %s failed\n", test, what);
+		failures++;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////
+void put8(Buffer& b, unsigned int x)
+{
+	b.push_back((unsigned char) x);
+}
+
+void put16(Buffer& b, unsigned int x)
+{
+	put8(b, x);
+	put8(b, x >> 8);
+}
+
+void put32(Buffer& b, unsigned int x)
+{
+	put16(b, x);
+	put16(b, x >> 16);
+}
+
+void put64(Buffer& b, unsigned long long x)
+{
+	put32(b, (unsigned int) x);
+	put32(b, (unsigned int) (x >> 32));
+}
+
+void patch32(Buffer& b, size_t off, unsigned int x)
+{
+	b[off] = (unsigned char) x;
+	b[off + 1] = (unsigned char) (x >> 8);
+	b[off + 2] = (unsigned char) (x >> 16);
+	b[off + 3] = (unsigned char) (x >> 24);
+}
+
+void putLEB128(Buffer& b, unsigned int x)
+{
+	while (x >= 0x80)
+	{
+		put8(b, (x & 0x7f) | 0x80);
+		x >>= 7;
+	}
+	put8(b, x);
+}
+
+void putString(Buffer& b, const char* s)
+{
+	b.insert(b.end(), s, s + strlen(s) + 1);
+}
+
+void addAbbrev(Buffer& b, int code, int tag, bool children, const int* attrs)
+{
+	putLEB128(b, code);
+	putLEB128(b, tag);
+	put8(b, children ? DW_CHILDREN_yes : DW_CHILDREN_no);
+	for (; attrs[0]; attrs += 2)
+	{
+		putLEB128(b, attrs[0]);
+		putLEB128(b, attrs[1]);
+	}
+	put8(b, 0);
+	put8(b, 0);
+}
+
+///////////////////////////////////////////////////////////////////////
+// little endian ELF64 executable with a section table, no program headers
+static const int SHT_PROGBITS = 1;
+static const int SHT_NOBITS = 8;
+static const int SHF_WRITE = 0x1;
+static const int SHF_ALLOC = 0x2;
+static const int SHF_EXECINSTR = 0x4;
+static const int SHF_TLS = 0x400;
+
+struct ELFSection
+{
+	const char* name;
+	int type;
+	unsigned long long flags;
+	unsigned long long addr;
+	Buffer data;
+	unsigned long long size; // SHT_NOBITS
+};
+
+static Buffer buildELF(const std::vector<ELFSection>& sections)
+{
+	Buffer names;
+	put8(names, 0);
+	std::vector<unsigned int> nameOffsets, dataOffsets;
+	Buffer img(64, 0);
+	for (size_t s = 0; s < sections.size(); s++)
+	{
+		nameOffsets.push_back(names.size());
+		putString(names, sections[s].name);
+		while (img.size() & 15)
+			put8(img, 0);
+		dataOffsets.push_back(img.size());
+		img.insert(img.end(), sections[s].data.begin(), sections[s].data.end());
+	}
+	unsigned int shstrName = names.size();
+	putString(names, ".shstrtab");
+	unsigned int shstrOffset = img.size();
+	img.insert(img.end(), names.begin(), names.end());
+	while (img.size() & 7)
+		put8(img, 0);
+
+	// null section, the given sections, .shstrtab
+	unsigned int shoff = img.size();
+	int shnum = sections.size() + 2;
+	img.resize(img.size() + 64, 0);
+	for (size_t s = 0; s < sections.size(); s++)
+	{
+		const ELFSection& es = sections[s];
+		put32(img, nameOffsets[s]);
+		put32(img, es.type);
+		put64(img, es.flags);
+		put64(img, es.addr);
+		put64(img, dataOffsets[s]);
+		put64(img, es.type == SHT_NOBITS ? es.size : es.data.size());
+		put32(img, 0); // link
+		put32(img, 0); // info
+		put64(img, 1); // addralign
+		put64(img, 0); // entsize
+	}
+	put32(img, shstrName);
+	put32(img, 3); // SHT_STRTAB
+	put64(img, 0);
+	put64(img, 0);
+	put64(img, shstrOffset);
+	put64(img, names.size());
+	img.resize(img.size() + 24, 0);
+
+	Buffer hdr;
+	put8(hdr, 0x7f); put8(hdr, 'E'); put8(hdr, 'L'); put8(hdr, 'F');
+	put8(hdr, 2); // ELFCLASS64
+	put8(hdr, 1); // ELFDATA2LSB
+	put8(hdr, 1); // EV_CURRENT
+	hdr.resize(16, 0);
+	put16(hdr, 2);  // ET_EXEC
+	put16(hdr, 62); // EM_X86_64
+	put32(hdr, 1);
+	put64(hdr, 0);  // entry
+	put64(hdr, 0);  // phoff
+	put64(hdr, shoff);
+	put32(hdr, 0);  // flags
+	put16(hdr, 64); // ehsize
+	put16(hdr, 0);  // phentsize
+	put16(hdr, 0);  // phnum
+	put16(hdr, 64); // shentsize
+	put16(hdr, shnum);
+	put16(hdr, shnum - 1);
+	memcpy(&img[0], &hdr[0], hdr.size());
+	return img;
+}
+
+static ELFSection section(const char* name, int type, unsigned long long flags, unsigned long long addr, const Buffer& data)
+{
+	ELFSection es = { name, type, flags, addr, data, data.size() };
+	return es;
+}
+
+// image with a code section and the given DWARF sections
+static bool loadDWARFImage(PEImage& img, const Buffer& info, const Buffer& abbrev)
+{
+	std::vector<ELFSection> sections;
+	sections.push_back(section(".text", SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, 0x401000, Buffer(16, 0xc3)));
+	sections.push_back(section(".debug_info", SHT_PROGBITS, 0, 0, info));
+	sections.push_back(section(".debug_abbrev", SHT_PROGBITS, 0, 0, abbrev));
+	sections.push_back(section(".debug_line", SHT_PROGBITS, 0, 0, Buffer()));
+	Buffer elf = buildELF(sections);
+	return img.loadMemory(&elf[0], elf.size());
+}
+
+///////////////////////////////////////////////////////////////////////
+// typedef int row[5]; row m[4]; with the DIE of row's array type following
+// the array type of m. The size of m is calculated when m is visited, before
+// the array types are created.
+static void testArrayBounds()
+{
+	const char* test = "array bounds";
+	enum { kCU = 1, kBaseType, kVariable, kArray, kSubrange, kTypedef };
+
+	Buffer abbrev;
+	const int cuAttrs[] = { DW_AT_name, DW_FORM_string, 0, 0 };
+	const int baseAttrs[] = { DW_AT_name, DW_FORM_string, DW_AT_byte_size, DW_FORM_data1, DW_AT_encoding, DW_FORM_data1, 0, 0 };
+	const int varAttrs[] = { DW_AT_name, DW_FORM_string, DW_AT_type, DW_FORM_ref4, 0, 0 };
+	const int arrayAttrs[] = { DW_AT_type, DW_FORM_ref4, 0, 0 };
+	const int subrangeAttrs[] = { DW_AT_upper_bound, DW_FORM_data1, 0, 0 };
+	addAbbrev(abbrev, kCU, DW_TAG_compile_unit, true, cuAttrs);
+	addAbbrev(abbrev, kBaseType, DW_TAG_base_type, false, baseAttrs);
+	addAbbrev(abbrev, kVariable, DW_TAG_variable, false, varAttrs);
+	addAbbrev(abbrev, kArray, DW_TAG_array_type, true, arrayAttrs);
+	addAbbrev(abbrev, kSubrange, DW_TAG_subrange_type, false, subrangeAttrs);
+	addAbbrev(abbrev, kTypedef, DW_TAG_typedef, false, varAttrs);
+	put8(abbrev, 0);
+
+	Buffer info;
+	put32(info, 0); // unit_length
+	put16(info, 2); // version
+	put32(info, 0); // debug_abbrev_offset
+	put8(info, 8);  // address_size
+	putLEB128(info, kCU);
+	putString(info, "test.c");
+
+	size_t intType = info.size();
+	putLEB128(info, kBaseType);
+	putString(info, "int");
+	put8(info, 4);
+	put8(info, DW_ATE_signed);
+
+	putLEB128(info, kVariable);
+	putString(info, "m");
+	size_t mRef = info.size();
+	put32(info, 0);
+
+	size_t mType = info.size(); // row[4]
+	putLEB128(info, kArray);
+	size_t mElemRef = info.size();
+	put32(info, 0);
+	putLEB128(info, kSubrange);
+	put8(info, 3);
+	put8(info, 0);
+
+	size_t rowType = info.size();
+	putLEB128(info, kTypedef);
+	putString(info, "row");
+	size_t rowRef = info.size();
+	put32(info, 0);
+
+	size_t rowArrayType = info.size(); // int[5]
+	putLEB128(info, kArray);
+	put32(info, intType);
+	putLEB128(info, kSubrange);
+	put8(info, 4);
+	put8(info, 0);
+
+	put8(info, 0); // end of the unit's children
+	patch32(info, 0, info.size() - 4);
+	patch32(info, mRef, mType);
+	patch32(info, mElemRef, rowType);
+	patch32(info, rowRef, rowArrayType);
+
+	PEImage img;
+	check(loadDWARFImage(img, info, abbrev), test, "loading the image");
+	if (!img.debug_info)
+		return;
+
+	CV2PDB cv2pdb(img);
+	DIECursor::setContext(&img);
+	check(cv2pdb.mapTypes(), test, "mapTypes");
+
+	DWARF_CompilationUnit* cu = (DWARF_CompilationUnit*) img.debug_info;
+	byte* mPtr = (byte*) img.debug_info + mType;
+	byte* rowArrayPtr = (byte*) img.debug_info + rowArrayType;
+	check(cv2pdb.getDWARFTypeSize(cu, mPtr) == 80, test, "size of row[4]");
+	check(cv2pdb.getDWARFTypeSize(cu, rowArrayPtr) == 20, test, "size of int[5]");
+
+	// the bounds are cached with the size, and used again when the array type is created
+	DWARF_InfoData id;
+	DIECursor cursor(cu, mPtr);
+	cursor.readNext(id);
+	int upperBound, lowerBound = cv2pdb.getDWARFArrayBounds(id, cu, cursor.getSubtreeCursor(), upperBound);
+	check(lowerBound == 0 && upperBound == 3, test, "bounds of row[4]");
+}
+
+///////////////////////////////////////////////////////////////////////
+// the bounded decoders take a fast path if 10 bytes are left, so each
+// encoding is decoded with exactly its size and with padding
+static bool decodesLEB128(const Buffer& enc, unsigned int value, bool isSigned)
+{
+	for (int pad = 0; pad <= 16; pad += 16)
+	{
+		Buffer b(enc);
+		b.insert(b.end(), pad, 0xff);
+		byte* p = &b[0];
+		byte* end = &b[0] + b.size();
+		unsigned int x = isSigned ? SLEB128(p, end) : LEB128(p, end);
+		if (x != value || p != &b[0] + enc.size())
+			return false;
+	}
+	return true;
+}
+
+static Buffer bytes(const char* s, size_t len)
+{
+	return Buffer(s, s + len);
+}
+
+static void testLEB128()
+{
+	const char* test = "LEB128";
+	check(decodesLEB128(bytes("\x05", 1), 5, false), test, "1 byte");
+	check(decodesLEB128(bytes("\x7f", 1), 127, false), test, "1 byte maximum");
+	check(decodesLEB128(bytes("\x80\x01", 2), 128, false), test, "2 bytes");
+	check(decodesLEB128(bytes("\xff\x7f", 2), 16383, false), test, "2 bytes maximum");
+	check(decodesLEB128(bytes("\xff\xff\xff\xff\x0f", 5), 0xffffffff, false), test, "5 bytes");
+	check(decodesLEB128(bytes("\x85\x80\x80\x80\x80\x80\x80\x80\x80\x01", 10), 5, false), test, "10 bytes, low 32 bits");
+
+	check(decodesLEB128(bytes("\x3f", 1), 63, true), test, "signed positive");
+	check(decodesLEB128(bytes("\x7f", 1), (unsigned) -1, true), test, "signed -1");
+	check(decodesLEB128(bytes("\xc0\x00", 2), 64, true), test, "signed 64");
+	check(decodesLEB128(bytes("\x80\x7f", 2), (unsigned) -128, true), test, "signed -128");
+	check(decodesLEB128(bytes("\x80\x80\x80\x80\x78", 5), 0x80000000, true), test, "signed minimum");
+	check(decodesLEB128(bytes("\xff\xff\xff\xff\xff\xff\xff\xff\xff\x7f", 10), (unsigned) -1, true), test, "signed 10 bytes");
+
+	// truncated values stop at end with the bits read so far
+	Buffer cut = bytes("\x81\x82", 2);
+	byte* p = &cut[0];
+	unsigned int x = LEB128(p, &cut[0] + cut.size());
+	check(x == 0x101 && p == &cut[0] + cut.size(), test, "truncated");
+
+	Buffer cont(12, 0x80);
+	p = &cont[0];
+	x = LEB128(p, &cont[0] + cont.size());
+	check(x == 0 && p == &cont[0] + cont.size(), test, "truncated after 10 bytes");
+
+	cut = bytes("\xff", 1);
+	p = &cut[0];
+	int sx = SLEB128(p, &cut[0] + cut.size());
+	check(sx == -1 && p == &cut[0] + cut.size(), test, "truncated signed");
+}
+
+///////////////////////////////////////////////////////////////////////
+// skipNext steps over the attribute values without decoding them, it must
+// reach the same DIEs as readNext and stay within the unit
+static std::vector<byte*> skippedDIEs(DWARF_CompilationUnit* cu)
+{
+	std::vector<byte*> dies;
+	DIECursor cursor(cu, cu->firstDIE());
+	for (;;)
+	{
+		byte* die = cursor.ptr;
+		if (!cursor.skipNext())
+			break;
+		if (*die != 0)
+			dies.push_back(die);
+	}
+	return dies;
+}
+
+static void testSkipForms()
+{
+	const char* test = "skip forms";
+	enum { kCU = 1, kBlocks, kData, kRefs, kTruncated };
+
+	Buffer abbrev;
+	const int cuAttrs[] = { DW_AT_name, DW_FORM_string, DW_AT_low_pc, DW_FORM_addr, 0, 0 };
+	const int blockAttrs[] = { DW_AT_const_value, DW_FORM_block1, DW_AT_const_value, DW_FORM_block2,
+	                           DW_AT_const_value, DW_FORM_block4, DW_AT_const_value, DW_FORM_block,
+	                           DW_AT_location, DW_FORM_exprloc, 0, 0 };
+	const int dataAttrs[] = { DW_AT_name, DW_FORM_string, DW_AT_byte_size, DW_FORM_data1, DW_AT_decl_line, DW_FORM_data2,
+	                          DW_AT_decl_file, DW_FORM_data4, DW_AT_const_value, DW_FORM_data8,
+	                          DW_AT_lower_bound, DW_FORM_sdata, DW_AT_upper_bound, DW_FORM_udata,
+	                          DW_AT_external, DW_FORM_flag, DW_AT_declaration, DW_FORM_flag_present,
+	                          DW_AT_count, DW_FORM_indirect, 0, 0 };
+	const int refAttrs[] = { DW_AT_type, DW_FORM_ref4, DW_AT_containing_type, DW_FORM_ref_udata,
+	                         DW_AT_ranges, DW_FORM_sec_offset, 0, 0 };
+	const int truncatedAttrs[] = { DW_AT_const_value, DW_FORM_block4, 0, 0 };
+	addAbbrev(abbrev, kCU, DW_TAG_compile_unit, true, cuAttrs);
+	addAbbrev(abbrev, kBlocks, DW_TAG_variable, false, blockAttrs);
+	addAbbrev(abbrev, kData, DW_TAG_subrange_type, true, dataAttrs);
+	addAbbrev(abbrev, kRefs, DW_TAG_pointer_type, false, refAttrs);
+	addAbbrev(abbrev, kTruncated, DW_TAG_variable, false, truncatedAttrs);
+	put8(abbrev, 0);
+
+	Buffer info;
+	put32(info, 0); // unit_length
+	put16(info, 4); // version
+	put32(info, 0); // debug_abbrev_offset
+	put8(info, 8);  // address_size
+	putLEB128(info, kCU);
+	putString(info, "forms.c");
+	put64(info, 0x401000);
+
+	putLEB128(info, kBlocks);
+	put8(info, 2); put16(info, 0x1234);
+	put16(info, 3); put8(info, 1); put8(info, 2); put8(info, 3);
+	put32(info, 1); put8(info, 4);
+	putLEB128(info, 200); info.resize(info.size() + 200, 0x80);
+	putLEB128(info, 2); put8(info, DW_OP_fbreg); put8(info, 0x70);
+
+	putLEB128(info, kData);
+	putString(info, "data");
+	put8(info, 4);
+	put16(info, 10);
+	put32(info, 1);
+	put64(info, ~0ULL);
+	putLEB128(info, 0x7f); // sdata -1
+	putLEB128(info, 300);
+	put8(info, 1);
+	putLEB128(info, DW_FORM_data2); put16(info, 5);
+
+	putLEB128(info, kRefs); // child of kData
+	put32(info, 11);
+	putLEB128(info, 11);
+	put32(info, 0);
+	put8(info, 0); // end of kData's children
+
+	putLEB128(info, kRefs);
+	put32(info, 11);
+	putLEB128(info, 1000);
+	put32(info, 0);
+	put8(info, 0); // end of the unit's children
+	patch32(info, 0, info.size() - 4);
+
+	size_t truncatedUnit = info.size();
+	put32(info, 0);
+	put16(info, 4);
+	put32(info, 0);
+	put8(info, 8);
+	putLEB128(info, kTruncated);
+	put32(info, 1000); // block extends beyond the unit
+	put8(info, 1); put8(info, 2);
+	patch32(info, truncatedUnit, info.size() - truncatedUnit - 4);
+
+	PEImage img;
+	check(loadDWARFImage(img, info, abbrev), test, "loading the image");
+	if (!img.debug_info)
+		return;
+	DIECursor::setContext(&img);
+
+	DWARF_CompilationUnit* cu = (DWARF_CompilationUnit*) img.debug_info;
+	std::vector<byte*> read;
+	DIECursor cursor(cu, cu->firstDIE());
+	DWARF_InfoData id;
+	while (cursor.readNext(id))
+		read.push_back(id.entryPtr);
+	check(read.size() == 5 && skippedDIEs(cu) == read, test, "skipNext and readNext find the same DIEs");
+
+	cu = (DWARF_CompilationUnit*) (img.debug_info + truncatedUnit);
+	byte* end = (byte*) cu + 4 + cu->unit_length;
+	DIECursor truncated(cu, cu->firstDIE());
+	check(truncated.skipNext() && truncated.ptr == end, test, "block clamped to the unit");
+	check(!truncated.skipNext(), test, "end of truncated unit");
+}
+
+///////////////////////////////////////////////////////////////////////
+// DWARF 5 unit with strings, addresses and range lists indexed through the
+// tables of the unit, and attributes with values in the abbreviation
+static void testDWARF5Units()
+{
+	const char* test = "DWARF 5";
+	enum { kCU = 1, kBaseType, kVariable, kConst };
+
+	Buffer abbrev;
+	const int cuAttrs[] = { DW_AT_name, DW_FORM_strx1, DW_AT_low_pc, DW_FORM_addrx, DW_AT_comp_dir, DW_FORM_line_strp,
+	                        DW_AT_str_offsets_base, DW_FORM_sec_offset, DW_AT_addr_base, DW_FORM_sec_offset,
+	                        DW_AT_rnglists_base, DW_FORM_sec_offset, DW_AT_ranges, DW_FORM_rnglistx, 0, 0 };
+	const int varAttrs[] = { DW_AT_name, DW_FORM_string, DW_AT_type, DW_FORM_ref4, DW_AT_location, DW_FORM_exprloc, 0, 0 };
+	const int constAttrs[] = { DW_AT_name, DW_FORM_string, DW_AT_const_value, DW_FORM_data16, DW_AT_external, DW_FORM_flag_present, 0, 0 };
+	addAbbrev(abbrev, kCU, DW_TAG_compile_unit, true, cuAttrs);
+	putLEB128(abbrev, kBaseType); // byte size 4 in the abbreviation
+	putLEB128(abbrev, DW_TAG_base_type);
+	put8(abbrev, DW_CHILDREN_no);
+	putLEB128(abbrev, DW_AT_name); putLEB128(abbrev, DW_FORM_strx1);
+	putLEB128(abbrev, DW_AT_byte_size); putLEB128(abbrev, DW_FORM_implicit_const); putLEB128(abbrev, 4);
+	putLEB128(abbrev, DW_AT_encoding); putLEB128(abbrev, DW_FORM_data1);
+	put8(abbrev, 0);
+	put8(abbrev, 0);
+	addAbbrev(abbrev, kVariable, DW_TAG_variable, false, varAttrs);
+	addAbbrev(abbrev, kConst, DW_TAG_variable, false, constAttrs);
+	put8(abbrev, 0);
+
+	Buffer str;
+	putString(str, "");
+	putString(str, "v5.c"); // 1
+	putString(str, "int");  // 6
+	Buffer lineStr;
+	putString(lineStr, "");
+	putString(lineStr, "/src"); // 1
+
+	Buffer strOffsets;
+	put32(strOffsets, 12); // unit_length
+	put16(strOffsets, 5);
+	put16(strOffsets, 0);  // padding
+	put32(strOffsets, 1);
+	put32(strOffsets, 6);
+
+	Buffer addr;
+	put32(addr, 20); // unit_length
+	put16(addr, 5);
+	put8(addr, 8);   // address_size
+	put8(addr, 0);   // segment_selector_size
+	put64(addr, 0x401000);
+	put64(addr, 0x401008);
+
+	Buffer rnglists;
+	put32(rnglists, 0); // unit_length
+	put16(rnglists, 5);
+	put8(rnglists, 8);
+	put8(rnglists, 0);
+	put32(rnglists, 1); // offset_entry_count
+	put32(rnglists, 4); // list 0, relative to the offsets
+	put8(rnglists, DW_RLE_offset_pair); putLEB128(rnglists, 0); putLEB128(rnglists, 4);
+	put8(rnglists, DW_RLE_startx_length); putLEB128(rnglists, 1); putLEB128(rnglists, 4);
+	put8(rnglists, DW_RLE_end_of_list);
+	patch32(rnglists, 0, rnglists.size() - 4);
+
+	Buffer info;
+	put32(info, 0); // unit_length
+	put16(info, 5); // version
+	put8(info, DW_UT_compile);
+	put8(info, 8);  // address_size
+	put32(info, 0); // debug_abbrev_offset
+	putLEB128(info, kCU);
+	put8(info, 0);       // name, string 0
+	putLEB128(info, 0);  // low_pc, address 0, before the address base
+	put32(info, 1);      // comp_dir
+	put32(info, 8);      // str_offsets_base
+	put32(info, 8);      // addr_base
+	put32(info, 12);     // rnglists_base
+	putLEB128(info, 0);  // ranges, list 0
+
+	size_t intType = info.size();
+	putLEB128(info, kBaseType);
+	put8(info, 1);
+	put8(info, DW_ATE_signed);
+
+	putLEB128(info, kVariable);
+	putString(info, "x");
+	put32(info, intType);
+	putLEB128(info, 2); put8(info, DW_OP_addrx); putLEB128(info, 1);
+
+	putLEB128(info, kConst);
+	putString(info, "c");
+	info.resize(info.size() + 16, 0x55);
+	put8(info, 0); // end of the unit's children
+	patch32(info, 0, info.size() - 4);
+
+	std::vector<ELFSection> sections;
+	sections.push_back(section(".text", SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, 0x401000, Buffer(16, 0xc3)));
+	sections.push_back(section(".debug_info", SHT_PROGBITS, 0, 0, info));
+	sections.push_back(section(".debug_abbrev", SHT_PROGBITS, 0, 0, abbrev));
+	sections.push_back(section(".debug_line", SHT_PROGBITS, 0, 0, Buffer()));
+	sections.push_back(section(".debug_str", SHT_PROGBITS, 0, 0, str));
+	sections.push_back(section(".debug_line_str", SHT_PROGBITS, 0, 0, lineStr));
+	sections.push_back(section(".debug_str_offsets", SHT_PROGBITS, 0, 0, strOffsets));
+	sections.push_back(section(".debug_addr", SHT_PROGBITS, 0, 0, addr));
+	sections.push_back(section(".debug_rnglists", SHT_PROGBITS, 0, 0, rnglists));
+	Buffer elf = buildELF(sections);
+
+	PEImage img;
+	check(img.loadMemory(&elf[0], elf.size()), test, "loading the image");
+	if (!img.debug_info || !img.debug_rnglists)
+		return;
+	DIECursor::setContext(&img);
+	CV2PDB cv2pdb(img);
+	check(cv2pdb.checkDWARFUnits(), test, "version accepted");
+
+	DWARF_CompilationUnit* cu = (DWARF_CompilationUnit*) img.debug_info;
+	check(cu->isCompileUnit() && cu->addressSize() == 8 && cu->abbrevOffset() == 0, test, "unit header");
+
+	std::vector<byte*> read;
+	DIECursor cursor(cu, cu->firstDIE());
+	DWARF_InfoData id;
+	check(cursor.readNext(id) && id.tag == DW_TAG_compile_unit, test, "unit DIE");
+	read.push_back(id.entryPtr);
+	check(id.name && strcmp(id.name, "v5.c") == 0, test, "DW_FORM_strx1");
+	check(id.dir && strcmp(id.dir, "/src") == 0, test, "DW_FORM_line_strp");
+	check(id.pclo == 0x401000, test, "DW_FORM_addrx before DW_AT_addr_base");
+
+	std::vector<DWARF_Range> ranges;
+	check(readDWARFRanges(cu, id.ranges, ranges) && ranges.size() == 2 &&
+	      ranges[0].pclo == 0x401000 && ranges[0].pchi == 0x401004 &&
+	      ranges[1].pclo == 0x401008 && ranges[1].pchi == 0x40100c, test, "DW_FORM_rnglistx");
+
+	check(cursor.readNext(id) && id.tag == DW_TAG_base_type, test, "base type DIE");
+	read.push_back(id.entryPtr);
+	check(id.name && strcmp(id.name, "int") == 0 && id.byte_size == 4, test, "DW_FORM_implicit_const");
+
+	check(cursor.readNext(id) && id.tag == DW_TAG_variable, test, "variable DIE");
+	read.push_back(id.entryPtr);
+	Location loc = decodeLocation(id.location);
+	check(loc.is_abs() && loc.off == 0x401008, test, "DW_OP_addrx");
+
+	check(cursor.readNext(id) && id.name && strcmp(id.name, "c") == 0, test, "DIE after DW_FORM_data16");
+	read.push_back(id.entryPtr);
+	check(!cursor.readNext(id), test, "end of the unit");
+	check(skippedDIEs(cu) == read, test, "skipNext and readNext find the same DIEs");
+
+	// the layout of later versions is unknown
+	cu->version = 6;
+	check(!cv2pdb.checkDWARFUnits(), test, "version 6 rejected");
+}
+
+// DWARF 4 adds maximum_operations_per_instruction, DWARF 5 the address and
+// segment selector size to the line number program header
+static void testLineHeaders()
+{
+	const char* test = "line header";
+	for (int version = 2; version <= 5; version++)
+	{
+		Buffer line;
+		put32(line, 0);   // unit_length
+		put16(line, version);
+		if (version >= 5)
+		{
+			put8(line, 8); // address_size
+			put8(line, 0); // segment_selector_size
+		}
+		put32(line, 0);   // header_length
+		put8(line, 1);    // minimum_instruction_length
+		if (version >= 4)
+			put8(line, 1); // maximum_operations_per_instruction
+		put8(line, 1);    // default_is_stmt
+		put8(line, 0xfb); // line_base
+		put8(line, 14);   // line_range
+		put8(line, 13);   // opcode_base
+		size_t opcodeLengths = line.size();
+		put8(line, 0);
+		patch32(line, 0, line.size() - 4);
+
+		DWARF_LineNumberProgramHeader hdr;
+		byte* p = &line[0];
+		bool ok = hdr.read(p, &line[0] + line.size());
+		check(ok && hdr.version == version && p == &line[opcodeLengths], test, "size of the header");
+		check(ok && hdr.line_base == -5 && hdr.line_range == 14 && hdr.opcode_base == 13, test, "fields");
+	}
+
+	Buffer line;
+	put32(line, 0xffffffff); // DWARF-64
+	put16(line, 4);
+	line.resize(32, 0);
+	DWARF_LineNumberProgramHeader hdr;
+	byte* p = &line[0];
+	check(!hdr.read(p, &line[0] + line.size()), test, "64-bit DWARF rejected");
+}
+
+///////////////////////////////////////////////////////////////////////
+// DW_OP_addr has the address size of the CU, the location keeps the low 32 bits
+static Location addrLocation(Buffer expr, int addrSize)
+{
+	DWARF_Attribute attr;
+	attr.type = ExprLoc;
+	attr.expr.ptr = &expr[0];
+	attr.expr.len = expr.size();
+	attr.expr.addrSize = addrSize;
+	attr.expr.addrBase = 0;
+	return decodeLocation(attr);
+}
+
+static void testAddrLocations()
+{
+	const char* test = "DW_OP_addr";
+	Buffer expr;
+	put8(expr, DW_OP_addr);
+	put32(expr, 0x401010);
+	Location loc = addrLocation(expr, 4);
+	check(loc.is_abs() && loc.off == 0x401010, test, "32-bit address");
+
+	expr.clear();
+	put8(expr, DW_OP_addr);
+	put64(expr, 0x140003010ULL);
+	loc = addrLocation(expr, 8);
+	check(loc.is_abs() && (unsigned) loc.off == 0x40003010, test, "64-bit address");
+
+	put8(expr, DW_OP_plus_uconst); // evaluated by the interpreter
+	put8(expr, 8);
+	loc = addrLocation(expr, 8);
+	check(loc.is_abs() && (unsigned) loc.off == 0x40003018, test, "64-bit address with offset");
+}
+
+///////////////////////////////////////////////////////////////////////
+// lookups by address use a sorted table with a cache of the last hit, or
+// the section headers in order if sections overlap
+static std::string sectionAt(const PEImage& img, unsigned int addr)
+{
+	int s = img.findSection(addr);
+	if (s < 0)
+		return "";
+	const char* name = (const char*) img.getSection(s).Name;
+	return std::string(name, strnlen(name, 8));
+}
+
+static void testSectionLookup()
+{
+	const char* test = "section lookup";
+	std::vector<ELFSection> sections;
+	sections.push_back(section(".text", SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, 0x401000, Buffer(0x100, 0xc3)));
+	sections.push_back(section(".rodata", SHT_PROGBITS, SHF_ALLOC, 0x401100, Buffer(0x100, 1))); // adjacent
+	sections.push_back(section(".data", SHT_PROGBITS, SHF_ALLOC | SHF_WRITE, 0x403000, Buffer(0x10, 2)));
+	Buffer elf = buildELF(sections);
+
+	PEImage img;
+	check(img.loadMemory(&elf[0], elf.size()), test, "load image");
+	check(sectionAt(img, 0x401000) == ".text" && sectionAt(img, 0x4010ff) == ".text", test, "first and last byte");
+	check(sectionAt(img, 0x401100) == ".rodata" && sectionAt(img, 0x4010ff) == ".text", test, "adjacent sections");
+	check(sectionAt(img, 0x403008) == ".data" && sectionAt(img, 0x401008) == ".text", test, "alternating lookups");
+	check(sectionAt(img, 0x401200) == "" && sectionAt(img, 0x402fff) == "", test, "gap between sections");
+	check(sectionAt(img, 0x400fff) == "" && sectionAt(img, 0x403010) == "", test, "before and after the image");
+	check(sectionAt(img, 0x4ffffff) == "" && sectionAt(img, 0x401000) == ".text", test, "far out of range");
+	// relative to the image base 0x401000
+	check(img.RVA<char>(0xf0, 0x10) != 0 && img.RVA<char>(0xf8, 0x10) == 0, test, "range across a section end");
+
+	// the line number thread and the converting thread share the cache
+	int mismatches[2] = { 0, 0 };
+	std::thread other([&]() {
+		for (int i = 0; i < 100000; i++)
+			mismatches[1] += img.findSection(0x403000 + (i & 15)) != 2;
+	});
+	for (int i = 0; i < 100000; i++)
+		mismatches[0] += img.findSection(0x401000 + (i & 0x1ff)) != (i & 0x100 ? 1 : 0);
+	other.join();
+	check(mismatches[0] == 0 && mismatches[1] == 0, test, "concurrent lookups");
+
+	// .init is contained in .text, .fini overlaps its end
+	sections.clear();
+	sections.push_back(section(".text", SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, 0x401000, Buffer(0x100, 0xc3)));
+	sections.push_back(section(".init", SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, 0x401040, Buffer(0x10, 0xc3)));
+	sections.push_back(section(".fini", SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, 0x4010f0, Buffer(0x20, 0xc3)));
+	elf = buildELF(sections);
+
+	PEImage overlap;
+	check(overlap.loadMemory(&elf[0], elf.size()), test, "load overlapping sections");
+	check(sectionAt(overlap, 0x401044) == ".text" && sectionAt(overlap, 0x4010f8) == ".text", test, "first section in header order");
+	check(sectionAt(overlap, 0x401100) == ".fini" && sectionAt(overlap, 0x40110f) == ".fini", test, "beyond the first section");
+	check(sectionAt(overlap, 0x401110) == "" && sectionAt(overlap, 0x400fff) == "", test, "out of range with overlaps");
+}
+
+///////////////////////////////////////////////////////////////////////
+// .tbss takes no space in the image, the following sections start at its
+// address. Lookups must find them instead of the thread local template.
+static void testTLSSections()
+{
+	const char* test = "TLS sections";
+	std::vector<ELFSection> sections;
+	sections.push_back(section(".text", SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, 0x401000, Buffer(16, 0xc3)));
+	ELFSection tbss = section(".tbss", SHT_NOBITS, SHF_ALLOC | SHF_WRITE | SHF_TLS, 0x403e00, Buffer());
+	tbss.size = 16;
+	sections.push_back(tbss);
+	sections.push_back(section(".init_array", SHT_PROGBITS, SHF_ALLOC | SHF_WRITE, 0x403e00, Buffer(8, 0)));
+	sections.push_back(section(".dynamic", SHT_PROGBITS, SHF_ALLOC | SHF_WRITE, 0x403e08, Buffer(16, 0)));
+	Buffer elf = buildELF(sections);
+
+	PEImage img;
+	check(img.loadMemory(&elf[0], elf.size()), test, "load image");
+	check(img.countSections() == 3, test, ".tbss not mapped");
+	int s = img.findSection(0x403e00);
+	check(s >= 0 && strncmp((const char*) img.getSection(s).Name, ".init_ar", 8) == 0, test, "section at .tbss address");
+	s = img.findSection(0x403e08);
+	check(s >= 0 && strncmp((const char*) img.getSection(s).Name, ".dynamic", 8) == 0, test, "section after .init_array");
+}
+
+///////////////////////////////////////////////////////////////////////
+// PE32 image with .text and .data and a COFF symbol table. findSymbol
+// returns 0-based section indices like findSection.
+static void putSymbol(Buffer& b, const char* name, unsigned int strOffset, unsigned int value, int section, int aux)
+{
+	size_t pos = b.size();
+	b.resize(pos + 8, 0);
+	if (strOffset)
+		patch32(b, pos + 4, strOffset);
+	else
+		memcpy(&b[pos], name, strlen(name));
+	put32(b, value);
+	put16(b, section & 0xffff);
+	put16(b, 0);    // type
+	put8(b, 2);     // IMAGE_SYM_CLASS_EXTERNAL
+	put8(b, aux);
+	b.resize(b.size() + aux * IMAGE_SIZEOF_SYMBOL, 0);
+}
+
+static void testCOFFSymbols()
+{
+	const char* test = "COFF symbols";
+	Buffer syms, strings(4, 0);
+	putSymbol(syms, ".file", 0, 0, -2, 1); // IMAGE_SYM_DEBUG with an aux record
+	putSymbol(syms, "_main", 0, 0x10, 1, 0);
+	putSymbol(syms, "_counter", 0, 4, 2, 0);
+	putSymbol(syms, 0, strings.size(), 8, 2, 0);
+	putString(strings, "_a_long_data_symbol");
+	putSymbol(syms, "_extern", 0, 0, 0, 0); // undefined
+	putSymbol(syms, "_abs", 0, 0x1234, -1, 0); // IMAGE_SYM_ABSOLUTE
+	patch32(strings, 0, strings.size());
+
+	Buffer img(0x400, 0);
+	IMAGE_DOS_HEADER* dos = (IMAGE_DOS_HEADER*) &img[0];
+	dos->e_magic = IMAGE_DOS_SIGNATURE;
+	dos->e_lfanew = 0x80;
+	IMAGE_NT_HEADERS32* nt = (IMAGE_NT_HEADERS32*) &img[0x80];
+	nt->Signature = IMAGE_NT_SIGNATURE;
+	nt->FileHeader.Machine = IMAGE_FILE_MACHINE_I386;
+	nt->FileHeader.NumberOfSections = 2;
+	nt->FileHeader.PointerToSymbolTable = img.size();
+	nt->FileHeader.NumberOfSymbols = syms.size() / IMAGE_SIZEOF_SYMBOL;
+	nt->FileHeader.SizeOfOptionalHeader = sizeof(IMAGE_OPTIONAL_HEADER32);
+	nt->OptionalHeader.Magic = 0x10b;
+	nt->OptionalHeader.ImageBase = 0x400000;
+	nt->OptionalHeader.NumberOfRvaAndSizes = IMAGE_NUMBEROF_DIRECTORY_ENTRIES;
+	IMAGE_SECTION_HEADER* sec = IMAGE_FIRST_SECTION(nt);
+	memcpy(sec[0].Name, ".text", 5);
+	sec[0].VirtualAddress = 0x1000;
+	sec[0].Misc.VirtualSize = sec[0].SizeOfRawData = 0x100;
+	sec[0].PointerToRawData = 0x200;
+	memcpy(sec[1].Name, ".data", 5);
+	sec[1].VirtualAddress = 0x2000;
+	sec[1].Misc.VirtualSize = sec[1].SizeOfRawData = 0x10;
+	sec[1].PointerToRawData = 0x300;
+	img.insert(img.end(), syms.begin(), syms.end());
+	img.insert(img.end(), strings.begin(), strings.end());
+
+	PEImage pe;
+	check(pe.loadMemory(&img[0], img.size()), test, "load image");
+	unsigned long off = 0;
+	check(pe.findSymbol("_main", off) == 0 && off == 0x10, test, "symbol in the first section");
+	check(pe.findSymbol("counter", off) == 1 && off == 4, test, "symbol without underscore in the second section");
+	check(pe.findSymbol("a_long_data_symbol", off) == 1 && off == 8, test, "symbol in the string table");
+	check(pe.findSymbol("_extern", off) < 0 && pe.findSymbol("abs", off) < 0, test, "undefined and absolute symbols");
+	check(pe.findSymbol(".file", off) < 0 && pe.findSymbol("missing", off) < 0, test, "debug and missing symbols");
+	check(pe.findSection(0x401010) == pe.findSymbol("main", off), test, "same index as findSection");
+}
+
+///////////////////////////////////////////////////////////////////////
+// MSF 7.00 file with 512 byte blocks holding the PDB stream (1) and the
+// DBI stream (3), the other streams are empty. With many streams the
+// directory needs more than one block map block.
+static Buffer buildMSF(unsigned int numStreams)
+{
+	const unsigned int blockSize = 512;
+	Buffer directory;
+	put32(directory, numStreams);
+	for (unsigned int s = 0; s < numStreams; s++)
+		put32(directory, s == 1 ? 28 : s == 3 ? 64 : 0);
+	unsigned int dirBlocks = (directory.size() + 8 + blockSize - 1) / blockSize;
+	unsigned int mapBlocks = (dirBlocks + blockSize / 4 - 1) / (blockSize / 4);
+
+	// super block, free block map, block map, directory, PDB stream, DBI stream
+	unsigned int firstMap = 2;
+	unsigned int firstDir = firstMap + mapBlocks;
+	unsigned int pdbBlock = firstDir + dirBlocks;
+	unsigned int dbiBlock = pdbBlock + 1;
+	put32(directory, pdbBlock);
+	put32(directory, dbiBlock);
+
+	Buffer msf((dbiBlock + 1) * blockSize, 0);
+	const char magic[] = "Microsoft C/C++ MSF 7.00\r\n\x1a" "DS\0\0";
+	Buffer sb(magic, magic + 32);
+	put32(sb, blockSize);
+	put32(sb, 1);
+	put32(sb, dbiBlock + 1);
+	put32(sb, directory.size());
+	put32(sb, 0);
+	for (unsigned int m = 0; m < mapBlocks; m++)
+		put32(sb, firstMap + m);
+	memcpy(&msf[0], &sb[0], sb.size());
+
+	Buffer map;
+	for (unsigned int b = 0; b < dirBlocks; b++)
+		put32(map, firstDir + b);
+	memcpy(&msf[firstMap * blockSize], &map[0], map.size());
+	memcpy(&msf[firstDir * blockSize], &directory[0], directory.size());
+
+	Buffer pdb;
+	put32(pdb, 20000404); // version
+	put32(pdb, 0x12345678); // signature
+	put32(pdb, 1); // age
+	pdb.resize(28, 0xaa); // GUID
+	memcpy(&msf[pdbBlock * blockSize], &pdb[0], pdb.size());
+
+	Buffer dbi;
+	put32(dbi, 0xffffffff);
+	put32(dbi, 19990903);
+	put32(dbi, 1); // age
+	memcpy(&msf[dbiBlock * blockSize], &dbi[0], dbi.size());
+	return msf;
+}
+
+static bool patchesMSF(const Buffer& msf, const GUID& guid, unsigned long age, Buffer& patched)
+{
+	const char* fname = "dwarftest.pdb";
+	FILE* fh = fopen(fname, "wb");
+	if (!fh)
+		return false;
+	fwrite(&msf[0], 1, msf.size(), fh);
+	fclose(fh);
+
+	PDBFile pdb;
+	bool ok = pdb.setSignature(fname, guid, age);
+	patched.assign(msf.size(), 0);
+	fh = fopen(fname, "rb");
+	if (!fh || fread(&patched[0], 1, patched.size(), fh) != patched.size())
+		ok = false;
+	if (fh)
+		fclose(fh);
+	remove(fname);
+	return ok;
+}
+
+static unsigned int get32(const Buffer& b, size_t off)
+{
+	return b[off] | (b[off + 1] << 8) | (b[off + 2] << 16) | ((unsigned int) b[off + 3] << 24);
+}
+
+static void testPDBSignature()
+{
+	const char* test = "PDB signature";
+	GUID guid;
+	memset(&guid, 0x5c, sizeof(guid));
+
+	const unsigned int numStreams[] = { 4, 20000 };
+	for (int i = 0; i < 2; i++)
+	{
+		Buffer msf = buildMSF(numStreams[i]), patched;
+		bool ok = patchesMSF(msf, guid, 7, patched);
+		check(ok, test, i ? "patching, two block map blocks" : "patching");
+		if (!ok)
+			continue;
+
+		unsigned int dbiBlock = msf.size() / 512 - 1;
+		size_t pdbOff = (dbiBlock - 1) * 512, dbiOff = dbiBlock * 512;
+		check(get32(patched, pdbOff) == 20000404 && get32(patched, pdbOff + 4) == 0x12345678,
+		      test, "PDB stream version and time stamp kept");
+		check(get32(patched, pdbOff + 8) == 7 && memcmp(&patched[pdbOff + 12], &guid, sizeof(guid)) == 0,
+		      test, "PDB stream age and GUID");
+		check(get32(patched, dbiOff + 8) == 7, test, "DBI stream age");
+
+		// nothing else is written
+		memcpy(&patched[pdbOff + 8], &msf[pdbOff + 8], 20);
+		memcpy(&patched[dbiOff + 8], &msf[dbiOff + 8], 4);
+		check(patched == msf, test, "other data unchanged");
+	}
+
+	Buffer bad = buildMSF(4), patched;
+	bad[0] = 'm';
+	check(!patchesMSF(bad, guid, 7, patched), test, "no MSF 7.00 file");
+}
+
+///////////////////////////////////////////////////////////////////////
+// zlib streams as written by zlib 1.2, gendwarf -z only emits stored blocks
+static const char fixedText[] = "hello, hello, hello DWARF";
+static const unsigned char fixedZlib[] = // Z_FIXED strategy
+{
+	0x78, 0x01, 0xcb, 0x48, 0xcd, 0xc9, 0xc9, 0xd7, 0x51, 0xc8, 0x40, 0xa2, 0x14, 0x5c, 0xc2, 0x1d,
+	0x83, 0xdc, 0x00, 0x72, 0x43, 0x08, 0x69,
+};
+
+static const unsigned char dynamicZlib[] = // level 9, text of dynamicText()
+{
+	0x78, 0xda, 0x9d, 0xd6, 0xc7, 0x11, 0xc2, 0x40, 0x0c, 0x40, 0xd1, 0x3b, 0x55, 0xa8, 0x04, 0x94,
+	0x48, 0xdd, 0x10, 0x16, 0x30, 0x18, 0x2f, 0x18, 0x4c, 0xaa, 0x9e, 0x81, 0x0e, 0xf8, 0x67, 0xcd,
+	0x3f, 0xe9, 0xcd, 0xae, 0xda, 0xa6, 0x2b, 0x32, 0x5e, 0xc8, 0x6d, 0x5f, 0xe4, 0x32, 0x34, 0xeb,
+	0xa3, 0xac, 0xfa, 0xfa, 0xe8, 0x64, 0x5b, 0x9f, 0x72, 0x18, 0x4e, 0xe7, 0xab, 0xd4, 0x7b, 0xe9,
+	0x7f, 0xe3, 0x76, 0xf9, 0x7e, 0xc9, 0xa6, 0xee, 0x46, 0xed, 0xb7, 0x51, 0xd0, 0x18, 0x68, 0x1c,
+	0x34, 0x01, 0x9a, 0x04, 0xcd, 0x04, 0x34, 0x53, 0xd0, 0xcc, 0x40, 0x33, 0x27, 0x3b, 0x45, 0x10,
+	0x88, 0x04, 0x25, 0x14, 0x94, 0x58, 0x50, 0x82, 0x41, 0x89, 0x06, 0x25, 0x1c, 0x94, 0x78, 0x50,
+	0x02, 0x42, 0x89, 0x08, 0x23, 0x22, 0x0c, 0xbd, 0x0d, 0x44, 0x84, 0x11, 0x11, 0x46, 0x44, 0x18,
+	0x11, 0x61, 0x44, 0x84, 0x11, 0x11, 0x46, 0x44, 0x18, 0x11, 0xe1, 0x44, 0x84, 0x13, 0x11, 0x8e,
+	0xbe, 0x0b, 0x22, 0xc2, 0x89, 0x08, 0x27, 0x22, 0x9c, 0x88, 0x70, 0x22, 0xc2, 0x89, 0x08, 0x27,
+	0x22, 0x82, 0x88, 0x08, 0x22, 0x22, 0x88, 0x88, 0x40, 0x17, 0x04, 0x11, 0x11, 0x44, 0x44, 0x10,
+	0x11, 0x41, 0x44, 0x04, 0x11, 0x11, 0x44, 0x44, 0x12, 0x11, 0x49, 0x44, 0x24, 0x11, 0x91, 0x44,
+	0x44, 0xa2, 0xa3, 0x92, 0x88, 0x48, 0x22, 0x22, 0x89, 0x88, 0x24, 0x22, 0xf2, 0x4f, 0x11, 0x1f,
+	0x95, 0xef, 0x57, 0x2d,
+};
+
+static std::string dynamicText()
+{
+	std::string text;
+	char line[80];
+	for (int i = 0; i < 60; i++)
+	{
+		sprintf(line, "line %d: the quick brown fox jumps over the lazy dog\n", i);
+		text += line;
+	}
+	return text;
+}
+
+static void testInflate()
+{
+	const char* test = "inflate";
+	Buffer out(strlen(fixedText));
+	check(inflateZlib(fixedZlib, sizeof(fixedZlib), &out[0], out.size()) &&
+	      memcmp(&out[0], fixedText, out.size()) == 0, test, "fixed Huffman codes");
+
+	std::string text = dynamicText();
+	out.assign(text.size(), 0);
+	check(inflateZlib(dynamicZlib, sizeof(dynamicZlib), &out[0], out.size()) &&
+	      memcmp(&out[0], text.data(), out.size()) == 0, test, "dynamic Huffman codes");
+
+	check(!inflateZlib(dynamicZlib, sizeof(dynamicZlib), &out[0], out.size() - 1), test, "size mismatch");
+	Buffer corrupt(dynamicZlib, dynamicZlib + sizeof(dynamicZlib));
+	corrupt[corrupt.size() - 1] ^= 1; // Adler-32
+	check(!inflateZlib(&corrupt[0], corrupt.size(), &out[0], out.size()), test, "checksum");
+}
+
+///////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+	testLEB128();
+	testSkipForms();
+	testDWARF5Units();
+	testLineHeaders();
+	testArrayBounds();
+	testAddrLocations();
+	testSectionLookup();
+	testTLSSections();
+	testCOFFSymbols();
+	testInflate();
+	testPDBSignature();
+
+	if (failures)
+		printf("%d tests failed\n", failures);
+	else
+		printf("all tests passed\n");
+	return failures ? 1 : 0;
+}
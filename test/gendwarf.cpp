@@ -0,0 +1,659 @@
+// Convert DMD CodeView/DWARF debug information to PDB files
+// Copyright (c) 2009-2012 by Rainer Schuetze, All Rights Reserved
+//
+// License for redistribution is given by the Artistic License 2.0
+// see file LICENSE for further details
+
+// generate a PE image with synthetic DWARF debug information to
+// benchmark the conversion without the need of a compiler
+
+#include "../src/pecoff.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <string>
+
+#include "../src/dwarf.h"
+
+typedef std::vector<unsigned char> Buffer;
+
+// content of the generated image
+int units = 10;      // compilation units
+int structs = 10;    // structs per unit
+int members = 8;     // members per struct
+int pointers = 2;    // length of the pointer chain to each struct
+int functions = 10;  // functions per unit
+int lines = 20;      // line number entries per function
+int nesting = 2;     // depth of nested lexical blocks per function
+bool shareAbbrev = true; // all units use the same abbreviation table
+bool accelTables = false; // add .debug_aranges and .debug_pubnames
+bool compressed = false;  // emit .zdebug_* sections
+
+const unsigned int imageBase = 0x400000;
+const unsigned int sectionAlign = 0x1000;
+const unsigned int fileAlign = 0x200;
+const unsigned int headerSize = 0x400;
+
+// statistics
+unsigned long long cntDIEs, cntTypes, cntLines;
+
+enum Abbrev
+{
+	kAbbrevCU = 1,
+	kAbbrevBaseType,
+	kAbbrevStruct,
+	kAbbrevMember,
+	kAbbrevPointer,
+	kAbbrevProc,
+	kAbbrevParam,
+	kAbbrevBlock,
+	kAbbrevVar,
+};
+
+void put8(Buffer& b, unsigned int x)
+{
+	b.push_back((unsigned char) x);
+}
+
+void put16(Buffer& b, unsigned int x)
+{
+	put8(b, x);
+	put8(b, x >> 8);
+}
+
+void put32(Buffer& b, unsigned int x)
+{
+	put16(b, x);
+	put16(b, x >> 16);
+}
+
+void patch32(Buffer& b, size_t off, unsigned int x)
+{
+	b[off] = (unsigned char) x;
+	b[off + 1] = (unsigned char) (x >> 8);
+	b[off + 2] = (unsigned char) (x >> 16);
+	b[off + 3] = (unsigned char) (x >> 24);
+}
+
+void putLEB128(Buffer& b, unsigned int x)
+{
+	while (x >= 0x80)
+	{
+		put8(b, (x & 0x7f) | 0x80);
+		x >>= 7;
+	}
+	put8(b, x);
+}
+
+void putSLEB128(Buffer& b, int x)
+{
+	for (;;)
+	{
+		int byte = x & 0x7f;
+		x >>= 7;
+		if ((x == 0 && !(byte & 0x40)) || (x == -1 && (byte & 0x40)))
+		{
+			put8(b, byte);
+			break;
+		}
+		put8(b, byte | 0x80);
+	}
+}
+
+void putString(Buffer& b, const char* s)
+{
+	b.insert(b.end(), s, s + strlen(s) + 1);
+}
+
+///////////////////////////////////////////////////////////////////////
+void addAbbrev(Buffer& b, int code, int tag, bool children, const int* attrs)
+{
+	putLEB128(b, code);
+	putLEB128(b, tag);
+	put8(b, children ? DW_CHILDREN_yes : DW_CHILDREN_no);
+	for (; attrs[0]; attrs += 2)
+	{
+		putLEB128(b, attrs[0]);
+		putLEB128(b, attrs[1]);
+	}
+	put8(b, 0);
+	put8(b, 0);
+}
+
+void addAbbrevTable(Buffer& b)
+{
+	static const int cuAttrs[] = { DW_AT_name, DW_FORM_string, DW_AT_comp_dir, DW_FORM_string,
+	                               DW_AT_language, DW_FORM_data1, DW_AT_low_pc, DW_FORM_addr,
+	                               DW_AT_high_pc, DW_FORM_data4, DW_AT_stmt_list, DW_FORM_sec_offset, 0 };
+	static const int baseAttrs[] = { DW_AT_name, DW_FORM_string, DW_AT_byte_size, DW_FORM_data1,
+	                                 DW_AT_encoding, DW_FORM_data1, 0 };
+	static const int structAttrs[] = { DW_AT_name, DW_FORM_string, DW_AT_byte_size, DW_FORM_udata, 0 };
+	static const int memberAttrs[] = { DW_AT_name, DW_FORM_string, DW_AT_type, DW_FORM_ref4,
+	                                   DW_AT_data_member_location, DW_FORM_udata, 0 };
+	static const int pointerAttrs[] = { DW_AT_byte_size, DW_FORM_data1, DW_AT_type, DW_FORM_ref4, 0 };
+	static const int procAttrs[] = { DW_AT_name, DW_FORM_string, DW_AT_external, DW_FORM_flag_present,
+	                                 DW_AT_low_pc, DW_FORM_addr, DW_AT_high_pc, DW_FORM_data4,
+	                                 DW_AT_frame_base, DW_FORM_exprloc, 0 };
+	static const int varAttrs[] = { DW_AT_name, DW_FORM_string, DW_AT_type, DW_FORM_ref4,
+	                                DW_AT_location, DW_FORM_exprloc, 0 };
+	static const int blockAttrs[] = { DW_AT_low_pc, DW_FORM_addr, DW_AT_high_pc, DW_FORM_data4, 0 };
+
+	addAbbrev(b, kAbbrevCU, DW_TAG_compile_unit, true, cuAttrs);
+	addAbbrev(b, kAbbrevBaseType, DW_TAG_base_type, false, baseAttrs);
+	addAbbrev(b, kAbbrevStruct, DW_TAG_structure_type, true, structAttrs);
+	addAbbrev(b, kAbbrevMember, DW_TAG_member, false, memberAttrs);
+	addAbbrev(b, kAbbrevPointer, DW_TAG_pointer_type, false, pointerAttrs);
+	addAbbrev(b, kAbbrevProc, DW_TAG_subprogram, true, procAttrs);
+	addAbbrev(b, kAbbrevParam, DW_TAG_formal_parameter, false, varAttrs);
+	addAbbrev(b, kAbbrevBlock, DW_TAG_lexical_block, true, blockAttrs);
+	addAbbrev(b, kAbbrevVar, DW_TAG_variable, false, varAttrs);
+	put8(b, 0);
+}
+
+///////////////////////////////////////////////////////////////////////
+unsigned int functionSize()
+{
+	unsigned int size = 4 * (lines > nesting ? lines : nesting) + 8;
+	return (size + 15) & ~15;
+}
+
+unsigned int unitSize()
+{
+	return functions * functionSize();
+}
+
+void addVariable(Buffer& b, int code, const char* name, unsigned int type, int fboff)
+{
+	putLEB128(b, code);
+	putString(b, name);
+	put32(b, type);
+	Buffer expr;
+	put8(expr, DW_OP_fbreg);
+	putSLEB128(expr, fboff);
+	putLEB128(b, expr.size());
+	b.insert(b.end(), expr.begin(), expr.end());
+	cntDIEs++;
+}
+
+void addBlocks(Buffer& b, unsigned int start, unsigned int end, int depth, unsigned int intType)
+{
+	if (depth >= nesting)
+		return;
+
+	putLEB128(b, kAbbrevBlock);
+	put32(b, start + 2);
+	put32(b, end - start - 4);
+	cntDIEs++;
+
+	char name[32];
+	sprintf(name, "v%d", depth);
+	addVariable(b, kAbbrevVar, name, intType, -4 * (depth + 1));
+	addBlocks(b, start + 2, end - 2, depth + 1, intType);
+	put8(b, 0);
+}
+
+// functions of the last unit, offsets relative to the unit
+std::vector<std::pair<unsigned int, std::string> > unitPublics;
+
+void addUnit(Buffer& info, unsigned int abbrevOff, unsigned int lineOff, int u, unsigned int codeStart)
+{
+	unitPublics.clear();
+
+	size_t cuOff = info.size();
+	put32(info, 0); // unit_length, patched below
+	put16(info, 4); // version
+	put32(info, abbrevOff);
+	put8(info, 4);  // address_size
+
+	char name[64];
+	sprintf(name, "unit%d.d", u);
+	putLEB128(info, kAbbrevCU);
+	putString(info, name);
+	putString(info, "c:\\gendwarf");
+	put8(info, DW_LANG_D);
+	put32(info, imageBase + codeStart);
+	put32(info, unitSize());
+	put32(info, lineOff);
+	cntDIEs++;
+
+	unsigned int intType = info.size() - cuOff;
+	putLEB128(info, kAbbrevBaseType);
+	putString(info, "int");
+	put8(info, 4);
+	put8(info, DW_ATE_signed);
+	cntDIEs++;
+	cntTypes++;
+
+	std::vector<unsigned int> structTypes; // pointer chain heads
+	for (int s = 0; s < structs; s++)
+	{
+		unsigned int structType = info.size() - cuOff;
+		sprintf(name, "S%d_%d", u, s);
+		putLEB128(info, kAbbrevStruct);
+		putString(info, name);
+		putLEB128(info, 4 * members);
+		cntDIEs++;
+		cntTypes++;
+		for (int m = 0; m < members; m++)
+		{
+			// odd members point to the previous struct
+			unsigned int type = (m & 1) && !structTypes.empty() ? structTypes.back() : intType;
+			sprintf(name, "m%d", m);
+			putLEB128(info, kAbbrevMember);
+			putString(info, name);
+			put32(info, type);
+			putLEB128(info, 4 * m);
+			cntDIEs++;
+		}
+		put8(info, 0);
+
+		unsigned int type = structType;
+		for (int p = 0; p < pointers; p++)
+		{
+			unsigned int ptrType = info.size() - cuOff;
+			putLEB128(info, kAbbrevPointer);
+			put8(info, 4);
+			put32(info, type);
+			type = ptrType;
+			cntDIEs++;
+			cntTypes++;
+		}
+		structTypes.push_back(pointers > 0 ? type : intType);
+	}
+
+	for (int f = 0; f < functions; f++)
+	{
+		unsigned int start = imageBase + codeStart + f * functionSize();
+		unsigned int end = start + functionSize();
+		sprintf(name, "F%d_%d", u, f);
+		unitPublics.push_back(std::make_pair((unsigned int) (info.size() - cuOff), std::string(name)));
+		putLEB128(info, kAbbrevProc);
+		putString(info, name);
+		put32(info, start);
+		put32(info, end - start);
+		putLEB128(info, 2);
+		put8(info, DW_OP_breg5);
+		putSLEB128(info, 8);
+		cntDIEs++;
+
+		unsigned int paramType = structTypes.empty() ? intType : structTypes[f % structTypes.size()];
+		addVariable(info, kAbbrevParam, "p", paramType, 0);
+		addBlocks(info, start, end, 0, intType);
+		put8(info, 0);
+	}
+	put8(info, 0);
+
+	patch32(info, cuOff, info.size() - cuOff - 4);
+}
+
+///////////////////////////////////////////////////////////////////////
+void addAranges(Buffer& aranges, unsigned int cuOff, unsigned int codeStart)
+{
+	size_t off = aranges.size();
+	put32(aranges, 0); // unit_length, patched below
+	put16(aranges, 2); // version
+	put32(aranges, cuOff);
+	put8(aranges, 4);  // address_size
+	put8(aranges, 0);  // segment_size
+	put32(aranges, 0); // padding to 8 byte alignment of the tuples
+	put32(aranges, imageBase + codeStart);
+	put32(aranges, unitSize());
+	put32(aranges, 0);
+	put32(aranges, 0);
+	patch32(aranges, off, aranges.size() - off - 4);
+}
+
+void addPubnames(Buffer& pubnames, unsigned int cuOff, unsigned int cuLength)
+{
+	size_t off = pubnames.size();
+	put32(pubnames, 0); // unit_length, patched below
+	put16(pubnames, 2); // version
+	put32(pubnames, cuOff);
+	put32(pubnames, cuLength);
+	for (size_t p = 0; p < unitPublics.size(); p++)
+	{
+		put32(pubnames, unitPublics[p].first);
+		putString(pubnames, unitPublics[p].second.c_str());
+	}
+	put32(pubnames, 0);
+	patch32(pubnames, off, pubnames.size() - off - 4);
+}
+
+///////////////////////////////////////////////////////////////////////
+const int lineBase = -5;
+const int lineRange = 14;
+const int opcodeBase = 13;
+
+void addLineProgram(Buffer& line, int u, unsigned int codeStart)
+{
+	size_t off = line.size();
+	put32(line, 0); // unit_length, patched below
+	put16(line, 3); // version
+	put32(line, 0); // header_length, patched below
+	size_t hdrStart = line.size();
+	put8(line, 1);  // minimum_instruction_length
+	put8(line, 1);  // default_is_stmt
+	put8(line, (unsigned char) lineBase);
+	put8(line, lineRange);
+	put8(line, opcodeBase);
+	static const unsigned char opcodeLengths[opcodeBase - 1] = { 0, 1, 1, 1, 1, 0, 0, 0, 1, 0, 0, 1 };
+	line.insert(line.end(), opcodeLengths, opcodeLengths + sizeof(opcodeLengths));
+	putString(line, "c:\\gendwarf");
+	put8(line, 0);
+
+	char name[64];
+	sprintf(name, "unit%d.d", u);
+	putString(line, name);
+	putLEB128(line, 1); // directory
+	putLEB128(line, 0); // modification time
+	putLEB128(line, 0); // file length
+	put8(line, 0);
+	patch32(line, hdrStart - 4, line.size() - hdrStart);
+
+	put8(line, 0);
+	putLEB128(line, 5);
+	put8(line, DW_LNE_set_address);
+	put32(line, imageBase + codeStart);
+
+	unsigned int addr = 0;
+	int ln = 1;
+	for (int f = 0; f < functions && lines > 0; f++)
+	{
+		unsigned int start = f * functionSize();
+		if (start > addr)
+		{
+			put8(line, DW_LNS_advance_pc);
+			putLEB128(line, start - addr);
+			addr = start;
+		}
+		int firstLine = f * (lines + 2) + 1;
+		if (firstLine != ln)
+		{
+			put8(line, DW_LNS_advance_line);
+			putSLEB128(line, firstLine - ln);
+			ln = firstLine;
+		}
+		put8(line, DW_LNS_copy);
+		cntLines++;
+
+		// 4 bytes of code per line
+		for (int l = 1; l < lines; l++)
+		{
+			put8(line, (1 - lineBase) + lineRange * 4 + opcodeBase);
+			addr += 4;
+			ln++;
+			cntLines++;
+		}
+	}
+	if (unitSize() > addr)
+	{
+		put8(line, DW_LNS_advance_pc);
+		putLEB128(line, unitSize() - addr);
+	}
+	put8(line, 0);
+	putLEB128(line, 1);
+	put8(line, DW_LNE_end_sequence);
+
+	patch32(line, off, line.size() - off - 4);
+}
+
+///////////////////////////////////////////////////////////////////////
+unsigned int alignUp(unsigned int x, unsigned int align)
+{
+	return (x + align - 1) & ~(align - 1);
+}
+
+// GNU style .zdebug_* section: "ZLIB", 8 byte big endian size and a zlib stream.
+// The data is kept in stored blocks, so no compressor is needed to exercise
+// the decompression in cv2pdb
+Buffer zlibSection(const Buffer& data)
+{
+	static const char magic[] = "ZLIB";
+	Buffer z(magic, magic + 4);
+	for (int i = 7; i >= 0; i--)
+		z.push_back((unsigned char) ((unsigned long long) data.size() >> (i * 8)));
+	z.push_back(0x78);
+	z.push_back(0x01);
+
+	size_t pos = 0;
+	do
+	{
+		size_t len = data.size() - pos < 0xffff ? data.size() - pos : 0xffff;
+		z.push_back(pos + len == data.size() ? 1 : 0); // BFINAL, BTYPE stored
+		z.push_back((unsigned char) len);
+		z.push_back((unsigned char) (len >> 8));
+		z.push_back((unsigned char) ~len);
+		z.push_back((unsigned char) (~len >> 8));
+		z.insert(z.end(), data.begin() + pos, data.begin() + pos + len);
+		pos += len;
+	} while (pos < data.size());
+
+	unsigned int a = 1, b = 0;
+	for (size_t i = 0; i < data.size(); i++)
+	{
+		a = (a + data[i]) % 65521;
+		b = (b + a) % 65521;
+	}
+	unsigned int adler = (b << 16) | a;
+	for (int i = 3; i >= 0; i--)
+		z.push_back((unsigned char) (adler >> (i * 8)));
+	return z;
+}
+
+struct Section
+{
+	const char* name;
+	Buffer data;
+	unsigned int characteristics;
+	IMAGE_SECTION_HEADER hdr;
+};
+
+bool writeImage(const char* fname, std::vector<Section>& sections)
+{
+	// long section names are stored in the string table of the COFF symbol table
+	Buffer strtab;
+	put32(strtab, 0);
+
+	unsigned int rawOff = headerSize;
+	unsigned int rva = sectionAlign;
+	for (size_t s = 0; s < sections.size(); s++)
+	{
+		IMAGE_SECTION_HEADER& hdr = sections[s].hdr;
+		memset(&hdr, 0, sizeof(hdr));
+		if (strlen(sections[s].name) <= 8)
+			strncpy((char*) hdr.Name, sections[s].name, 8);
+		else
+		{
+			sprintf((char*) hdr.Name, "/%u", (unsigned int) strtab.size());
+			putString(strtab, sections[s].name);
+		}
+		hdr.Misc.VirtualSize = sections[s].data.size();
+		hdr.VirtualAddress = rva;
+		hdr.SizeOfRawData = alignUp(sections[s].data.size(), fileAlign);
+		hdr.PointerToRawData = rawOff;
+		hdr.Characteristics = sections[s].characteristics;
+		rawOff += hdr.SizeOfRawData;
+		rva += alignUp(sections[s].data.size(), sectionAlign);
+	}
+	patch32(strtab, 0, strtab.size());
+
+	IMAGE_DOS_HEADER dos;
+	memset(&dos, 0, sizeof(dos));
+	dos.e_magic = IMAGE_DOS_SIGNATURE;
+	dos.e_lfanew = sizeof(dos);
+
+	IMAGE_NT_HEADERS32 nt;
+	memset(&nt, 0, sizeof(nt));
+	nt.Signature = IMAGE_NT_SIGNATURE;
+	nt.FileHeader.Machine = IMAGE_FILE_MACHINE_I386;
+	nt.FileHeader.NumberOfSections = sections.size();
+	nt.FileHeader.PointerToSymbolTable = rawOff;
+	nt.FileHeader.NumberOfSymbols = 0;
+	nt.FileHeader.SizeOfOptionalHeader = sizeof(nt.OptionalHeader);
+	nt.FileHeader.Characteristics = IMAGE_FILE_EXECUTABLE_IMAGE | IMAGE_FILE_32BIT_MACHINE;
+	nt.OptionalHeader.Magic = IMAGE_NT_OPTIONAL_HDR32_MAGIC;
+	nt.OptionalHeader.SizeOfCode = sections[0].hdr.SizeOfRawData;
+	nt.OptionalHeader.AddressOfEntryPoint = sections[0].hdr.VirtualAddress;
+	nt.OptionalHeader.BaseOfCode = sections[0].hdr.VirtualAddress;
+	nt.OptionalHeader.ImageBase = imageBase;
+	nt.OptionalHeader.SectionAlignment = sectionAlign;
+	nt.OptionalHeader.FileAlignment = fileAlign;
+	nt.OptionalHeader.MajorOperatingSystemVersion = 4;
+	nt.OptionalHeader.MajorSubsystemVersion = 4;
+	nt.OptionalHeader.SizeOfImage = rva;
+	nt.OptionalHeader.SizeOfHeaders = headerSize;
+	nt.OptionalHeader.Subsystem = IMAGE_SUBSYSTEM_WINDOWS_CUI;
+	nt.OptionalHeader.SizeOfStackReserve = 0x100000;
+	nt.OptionalHeader.SizeOfStackCommit = 0x1000;
+	nt.OptionalHeader.SizeOfHeapReserve = 0x100000;
+	nt.OptionalHeader.SizeOfHeapCommit = 0x1000;
+	nt.OptionalHeader.NumberOfRvaAndSizes = IMAGE_NUMBEROF_DIRECTORY_ENTRIES;
+
+	Buffer image;
+	image.insert(image.end(), (unsigned char*) &dos, (unsigned char*) (&dos + 1));
+	image.insert(image.end(), (unsigned char*) &nt, (unsigned char*) (&nt + 1));
+	for (size_t s = 0; s < sections.size(); s++)
+		image.insert(image.end(), (unsigned char*) &sections[s].hdr, (unsigned char*) (&sections[s].hdr + 1));
+	if (image.size() > headerSize)
+		return false;
+
+	image.resize(headerSize, 0);
+	for (size_t s = 0; s < sections.size(); s++)
+	{
+		image.insert(image.end(), sections[s].data.begin(), sections[s].data.end());
+		image.resize(sections[s].hdr.PointerToRawData + sections[s].hdr.SizeOfRawData, 0);
+	}
+	image.insert(image.end(), strtab.begin(), strtab.end());
+
+	FILE* fh = fopen(fname, "wb");
+	if (!fh)
+		return false;
+	bool ok = fwrite(&image[0], 1, image.size(), fh) == image.size();
+	if (fclose(fh) != 0)
+		ok = false;
+	return ok;
+}
+
+///////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+	while (argc > 1 && argv[1][0] == '-')
+	{
+		argv++;
+		argc--;
+		if (argv[0][1] == 'c')
+			units = atoi(argv[0] + 2);
+		else if (argv[0][1] == 's')
+			structs = atoi(argv[0] + 2);
+		else if (argv[0][1] == 'm')
+			members = atoi(argv[0] + 2);
+		else if (argv[0][1] == 'p')
+			pointers = atoi(argv[0] + 2);
+		else if (argv[0][1] == 'f')
+			functions = atoi(argv[0] + 2);
+		else if (argv[0][1] == 'l')
+			lines = atoi(argv[0] + 2);
+		else if (argv[0][1] == 'n')
+			nesting = atoi(argv[0] + 2);
+		else if (argv[0][1] == 'a')
+			shareAbbrev = false;
+		else if (argv[0][1] == 't')
+			accelTables = true;
+		else if (argv[0][1] == 'z')
+			compressed = true;
+		else
+		{
+			printf("unknown option: %s\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (argc < 2)
+	{
+		printf("Generate a PE image with synthetic DWARF debug information\n");
+		printf("\n");
+		printf("usage: %s [options] <exe-file>\n", argv[0]);
+		printf("  -c<n>  number of compilation units (default %d)\n", units);
+		printf("  -s<n>  structs per unit (default %d)\n", structs);
+		printf("  -m<n>  members per struct (default %d)\n", members);
+		printf("  -p<n>  length of pointer chain to each struct (default %d)\n", pointers);
+		printf("  -f<n>  functions per unit (default %d)\n", functions);
+		printf("  -l<n>  line number entries per function (default %d)\n", lines);
+		printf("  -n<n>  depth of nested lexical blocks (default %d)\n", nesting);
+		printf("  -a     separate abbreviation table for each unit\n");
+		printf("  -t     add .debug_aranges and .debug_pubnames\n");
+		printf("  -z     emit compressed .zdebug_* sections\n");
+		return -1;
+	}
+
+	if (units < 1 || functions < 1 || structs < 0 || members < 0 || pointers < 0 || lines < 0 || nesting < 0)
+	{
+		printf("invalid options\n");
+		return 1;
+	}
+
+	std::vector<Section> sections(accelTables ? 6 : 4);
+	sections[0].name = ".text";
+	sections[0].characteristics = IMAGE_SCN_CNT_CODE | IMAGE_SCN_MEM_EXECUTE | IMAGE_SCN_MEM_READ;
+	sections[1].name = ".debug_abbrev";
+	sections[2].name = ".debug_info";
+	sections[3].name = ".debug_line";
+	if (accelTables)
+	{
+		sections[4].name = ".debug_aranges";
+		sections[5].name = ".debug_pubnames";
+	}
+	for (size_t s = 1; s < sections.size(); s++)
+		sections[s].characteristics = IMAGE_SCN_CNT_INITIALIZED_DATA | IMAGE_SCN_MEM_DISCARDABLE | IMAGE_SCN_MEM_READ;
+
+	Buffer& text = sections[0].data;
+	Buffer& abbrev = sections[1].data;
+	Buffer& info = sections[2].data;
+	Buffer& line = sections[3].data;
+	Buffer aranges, pubnames;
+
+	text.resize((size_t) units * unitSize(), 0xcc); // int 3
+	for (int u = 0; u < units; u++)
+	{
+		unsigned int abbrevOff = shareAbbrev ? 0 : abbrev.size();
+		if (u == 0 || !shareAbbrev)
+			addAbbrevTable(abbrev);
+
+		unsigned int codeStart = sectionAlign + u * unitSize();
+		unsigned int lineOff = line.size();
+		addLineProgram(line, u, codeStart);
+		unsigned int cuOff = info.size();
+		addUnit(info, abbrevOff, lineOff, u, codeStart);
+		if (accelTables)
+		{
+			addAranges(aranges, cuOff, codeStart);
+			addPubnames(pubnames, cuOff, info.size() - cuOff);
+		}
+	}
+	if (accelTables)
+	{
+		sections[4].data = aranges;
+		sections[5].data = pubnames;
+	}
+
+	printf("%s: %d units, %llu DIEs, %llu types, %llu line entries\n", argv[1], units, cntDIEs, cntTypes, cntLines);
+	printf("  .debug_info %u bytes, .debug_abbrev %u bytes, .debug_line %u bytes\n",
+	       (unsigned int) info.size(), (unsigned int) abbrev.size(), (unsigned int) line.size());
+
+	std::vector<std::string> znames(sections.size());
+	if (compressed)
+		for (size_t s = 1; s < sections.size(); s++)
+		{
+			znames[s] = std::string(".z") + (sections[s].name + 1);
+			sections[s].name = znames[s].c_str();
+			sections[s].data = zlibSection(sections[s].data);
+		}
+
+	if (!writeImage(argv[1], sections))
+	{
+		printf("%s: cannot write image\n", argv[1]);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,481 @@
+// Convert DMD CodeView/DWARF debug information to PDB files
+// Copyright (c) 2009-2012 by Rainer Schuetze, All Rights Reserved
+//
+// License for redistribution is given by the Artistic License 2.0
+// see file LICENSE for further details
+
+// micro benchmarks of the DWARF reader primitives and the symbol string
+// routines. Samples are taken from the DWARF debug information of the
+// image given on the command line, or generated if no image is given.
+
+#include "../src/PEImage.h"
+#include "../src/readDwarf.h"
+#include "../src/symutil.h"
+#include "../src/demangle.h"
+#include "../src/dwarf.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////
+// count allocations through operator new
+static unsigned long long allocations;
+
+void* operator new(size_t size)
+{
+	allocations++;
+	if (void* p = malloc(size ? size : 1))
+		return p;
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* p) throw()
+{
+	free(p);
+}
+
+void operator delete[](void* p) throw()
+{
+	free(p);
+}
+
+///////////////////////////////////////////////////////////////////////
+static double now()
+{
+#ifdef _WIN32
+	LARGE_INTEGER freq, cnt;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&cnt);
+	return (double) cnt.QuadPart / freq.QuadPart;
+#else
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+static double minTime = 0.2; // seconds per benchmark
+static volatile unsigned long long sink; // keeps results alive
+
+// run pass() until minTime has elapsed, each pass executes ops operations
+template<class Pass>
+void bench(const char* name, size_t ops, Pass pass)
+{
+	if (ops == 0)
+	{
+		printf("%-24s %12s\n", name, "no samples");
+		return;
+	}
+
+	unsigned long long result = pass(); // warm up
+	unsigned long long passes = 0;
+	unsigned long long allocs = allocations;
+	double start = now(), elapsed;
+	do
+	{
+		result += pass();
+		passes++;
+		elapsed = now() - start;
+	}
+	while (elapsed < minTime);
+	allocs = allocations - allocs;
+	sink += result;
+
+	double cnt = (double) passes * ops;
+	printf("%-24s %12.2f %12.3f %12llu\n", name, elapsed * 1e9 / cnt, allocs / cnt, (unsigned long long) ops);
+}
+
+///////////////////////////////////////////////////////////////////////
+// samples
+static std::vector<byte> ulebs;
+static size_t cntULEB;
+static std::vector<byte> slebs;
+static size_t cntSLEB;
+static std::vector<byte> fixed;
+static std::vector<int> fixedSizes;
+static std::vector<std::pair<unsigned, unsigned> > abbrevs;
+static std::vector<DWARF_Attribute> locations;
+static std::vector<Location> frameBases;
+static std::vector<std::string> names;
+static std::vector<std::string> mangled;
+static std::vector<std::vector<BYTE> > pnames;
+
+static void putULEB(unsigned int x)
+{
+	while (x >= 0x80)
+	{
+		ulebs.push_back((byte) ((x & 0x7f) | 0x80));
+		x >>= 7;
+	}
+	ulebs.push_back((byte) x);
+	cntULEB++;
+}
+
+static void putSLEB(int x)
+{
+	for (;;)
+	{
+		byte b = x & 0x7f;
+		x >>= 7;
+		if ((x == 0 && !(b & 0x40)) || (x == -1 && (b & 0x40)))
+		{
+			slebs.push_back(b);
+			break;
+		}
+		slebs.push_back(b | 0x80);
+	}
+	cntSLEB++;
+}
+
+static void putFixed(const byte* p, int size)
+{
+	fixed.insert(fixed.end(), p, p + size);
+	fixedSizes.push_back(size);
+}
+
+static void sampleLocation(const DWARF_Attribute& attr, const Location& frameBase)
+{
+	if (attr.type != ExprLoc || attr.expr.len == 0)
+		return;
+	locations.push_back(attr);
+	frameBases.push_back(frameBase);
+
+	byte* p = attr.expr.ptr;
+	int op = *p++;
+	if (op == DW_OP_fbreg || (op >= DW_OP_breg0 && op <= DW_OP_breg31))
+		putSLEB(SLEB128(p));
+	else if (op == DW_OP_plus_uconst || op == DW_OP_regx)
+		putULEB(LEB128(p));
+}
+
+// read all DIEs of the image, the view skips the attribute values
+template<typename DIE>
+static unsigned long long walkDIEs(PEImage& img)
+{
+	unsigned long long sum = 0;
+	for (unsigned long off = 0; off < img.debug_info_length; )
+	{
+		DWARF_CompilationUnit* cu = (DWARF_CompilationUnit*)(img.debug_info + off);
+		DIECursor cursor(cu, cu->firstDIE());
+		DIE die;
+		while (cursor.readNext(die))
+			sum += die.tag;
+		off += sizeof(cu->unit_length) + cu->unit_length;
+	}
+	return sum;
+}
+
+// visit the children of all compilation units, skipping their subtrees
+static unsigned long long skipSubtrees(PEImage& img, size_t& calls)
+{
+	unsigned long long sum = 0;
+	for (unsigned long off = 0; off < img.debug_info_length; )
+	{
+		DWARF_CompilationUnit* cu = (DWARF_CompilationUnit*)(img.debug_info + off);
+		DIECursor cursor(cu, cu->firstDIE());
+		DWARF_DIEView die;
+		if (cursor.readNext(die))
+		{
+			DIECursor children = cursor.getSubtreeCursor();
+			while (children.readSibling(die))
+			{
+				sum += die.tag;
+				calls++;
+			}
+		}
+		off += sizeof(cu->unit_length) + cu->unit_length;
+	}
+	return sum;
+}
+
+static void sampleImage(PEImage& img)
+{
+	DIECursor::setContext(&img);
+
+	for (unsigned long off = 0; off < img.debug_info_length; )
+	{
+		DWARF_CompilationUnit* cu = (DWARF_CompilationUnit*)(img.debug_info + off);
+		DIECursor cursor(cu, cu->firstDIE());
+		DWARF_InfoData id;
+		Location frameBase = { Location::Invalid };
+		while (cursor.readNext(id))
+		{
+			putULEB(id.code);
+			abbrevs.push_back(std::make_pair(cu->abbrevOffset(), (unsigned) id.code));
+			putFixed(id.entryPtr, cu->addressSize());
+
+			if (id.tag == DW_TAG_subprogram)
+				frameBase = decodeLocation(id.frame_base);
+			sampleLocation(id.location, frameBase);
+			sampleLocation(id.member_location, frameBase);
+			sampleLocation(id.frame_base, frameBase);
+
+			if (id.name)
+				names.push_back(id.name);
+			if (id.linkage_name && id.linkage_name[0] == '_' && id.linkage_name[1] == 'D')
+				mangled.push_back(id.linkage_name);
+			else if (id.name && id.name[0] == '_' && id.name[1] == 'D')
+				mangled.push_back(id.name);
+		}
+		off += sizeof(cu->unit_length) + cu->unit_length;
+	}
+
+	// attribute and form codes of the abbreviation table
+	byte* p = (byte*) img.debug_abbrev;
+	byte* end = p + img.debug_abbrev_length;
+	while (p < end)
+	{
+		unsigned int code = LEB128(p);
+		if (code == 0 || p >= end)
+			continue;
+		putULEB(code);
+		putULEB(LEB128(p)); // tag
+		p++; // children
+		while (p < end)
+		{
+			unsigned int attr = LEB128(p);
+			unsigned int form = LEB128(p);
+			if (attr == 0 && form == 0)
+				break;
+			putULEB(attr);
+			putULEB(form);
+		}
+	}
+}
+
+static void generateSamples()
+{
+	// mostly small values like abbreviation codes, some offsets and sizes
+	srand(1);
+	for (int i = 0; i < 100000; i++)
+	{
+		int r = rand() % 100;
+		putULEB(r < 70 ? rand() % 0x80 : r < 95 ? rand() % 0x4000 : rand() * 0x100 + rand() % 0x100);
+		putSLEB(r < 80 ? rand() % 0x80 - 0x40 : rand() % 0x4000 - 0x2000);
+		byte raw[8];
+		for (int b = 0; b < 8; b++)
+			raw[b] = (byte) rand();
+		putFixed(raw, r < 80 ? 4 : r < 90 ? 2 : r < 95 ? 1 : 8);
+	}
+
+	// frame base, parameters and locals, members, registers, globals
+	static byte exprs[] =
+	{
+		2, DW_OP_breg5, 8,
+		2, DW_OP_fbreg, 0,
+		2, DW_OP_fbreg, 0x7c,
+		3, DW_OP_fbreg, 0xe0, 0x7e,
+		2, DW_OP_plus_uconst, 12,
+		1, DW_OP_reg0,
+		5, DW_OP_addr, 0x00, 0x10, 0x40, 0x00,
+	};
+	Location frameBase = { Location::RegRel, 5, 8 };
+	for (size_t i = 0; i < sizeof(exprs); i += exprs[i] + 1)
+	{
+		DWARF_Attribute attr;
+		attr.type = ExprLoc;
+		attr.expr.len = exprs[i];
+		attr.expr.ptr = exprs + i + 1;
+		attr.expr.addrSize = 4;
+		attr.expr.addrBase = 0;
+		locations.push_back(attr);
+		frameBases.push_back(frameBase);
+	}
+
+	static const char* dnames[] =
+	{
+		"_D6object6Object8toStringMFZAya",
+		"_D3std5stdio4File5closeMFZv",
+		"_D4core4sync5mutex5Mutex4lockMFZv",
+		"_D3std5array__T8AppenderTAyaZ8Appender3putMFNaNbNfwZv",
+		"_D3std6format__T10formatNthTS3std5array17__T8AppenderTAyaZ8AppenderTaTiZ10formatNthFNfS3std5array17__T8AppenderTAyaZ8AppenderKxS3std6format18__T10FormatSpecTaZ10FormatSpeckiZv",
+		"_D6cvtest10testStructFS6cvtest6StructZi",
+	};
+	static const char* cnames[] =
+	{
+		"i", "this", "length", "ptr", "toString", "opEquals", "main", "writeln",
+		"std.stdio.File", "object.TypeInfo_Struct", "core.thread.Thread.start",
+	};
+	for (size_t i = 0; i < sizeof(dnames) / sizeof(dnames[0]); i++)
+		mangled.push_back(dnames[i]);
+	for (size_t i = 0; i < sizeof(cnames) / sizeof(cnames[0]); i++)
+		names.push_back(cnames[i]);
+}
+
+///////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+	while (argc > 1 && argv[1][0] == '-')
+	{
+		argv++;
+		argc--;
+		if (argv[0][1] == 't')
+			minTime = atof(argv[0] + 2);
+		else
+		{
+			printf("usage: microbench [-t<seconds>] [exe-file]\n");
+			return 1;
+		}
+	}
+
+	PEImage img;
+	if (argc > 1)
+	{
+		if (!img.load(argv[1]))
+		{
+			printf("%s: %s\n", argv[1], img.getLastError());
+			return 1;
+		}
+		if (!img.hasDWARF())
+		{
+			printf("%s: no DWARF debug information found\n", argv[1]);
+			return 1;
+		}
+		sampleImage(img);
+	}
+	else
+		generateSamples();
+
+	// names as pascal strings for the CodeView routines
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		std::vector<BYTE> p(names[i].size() + 4);
+		c2p(names[i].c_str(), &p[0]);
+		pnames.push_back(p);
+	}
+	for (size_t i = 0; i < mangled.size(); i++)
+	{
+		std::vector<BYTE> p(mangled[i].size() + 4);
+		c2p(mangled[i].c_str(), &p[0]);
+		pnames.push_back(p);
+	}
+
+	static char cname[kMaxNameLen];
+	static BYTE buf[kMaxNameLen + 4];
+
+	printf("%-24s %12s %12s %12s\n", "kernel", "ns/op", "allocs/op", "samples");
+
+	bench("LEB128", cntULEB, []() -> unsigned long long {
+		unsigned long long sum = 0;
+		byte* p = ulebs.data();
+		for (size_t i = 0; i < cntULEB; i++)
+			sum += LEB128(p);
+		return sum;
+	});
+	bench("SLEB128", cntSLEB, []() -> unsigned long long {
+		unsigned long long sum = 0;
+		byte* p = slebs.data();
+		for (size_t i = 0; i < cntSLEB; i++)
+			sum += SLEB128(p);
+		return sum;
+	});
+	bench("LEB128 (bounded)", cntULEB, []() -> unsigned long long {
+		unsigned long long sum = 0;
+		byte* p = ulebs.data();
+		byte* end = p + ulebs.size();
+		for (size_t i = 0; i < cntULEB; i++)
+			sum += LEB128(p, end);
+		return sum;
+	});
+	bench("SLEB128 (bounded)", cntSLEB, []() -> unsigned long long {
+		unsigned long long sum = 0;
+		byte* p = slebs.data();
+		byte* end = p + slebs.size();
+		for (size_t i = 0; i < cntSLEB; i++)
+			sum += SLEB128(p, end);
+		return sum;
+	});
+	bench("RDsize", fixedSizes.size(), []() -> unsigned long long {
+		unsigned long long sum = 0;
+		byte* p = fixed.data();
+		for (size_t i = 0; i < fixedSizes.size(); i++)
+			sum += RDsize(p, fixedSizes[i]);
+		return sum;
+	});
+	if (img.hasDWARF())
+	{
+		DIECursor cursor((DWARF_CompilationUnit*) img.debug_info, (byte*) img.debug_info);
+		bench("getDWARFAbbrev", abbrevs.size(), [&cursor]() -> unsigned long long {
+			unsigned long long sum = 0;
+			for (size_t i = 0; i < abbrevs.size(); i++)
+				sum += (size_t) cursor.getDWARFAbbrev(abbrevs[i].first, abbrevs[i].second);
+			return sum;
+		});
+		bench("readNext (InfoData)", abbrevs.size(), [&img]() -> unsigned long long {
+			return walkDIEs<DWARF_InfoData>(img);
+		});
+		bench("readNext (DIEView)", abbrevs.size(), [&img]() -> unsigned long long {
+			return walkDIEs<DWARF_DIEView>(img);
+		});
+		size_t siblings = 0;
+		skipSubtrees(img, siblings);
+		bench("readSibling (skip)", siblings, [&img]() -> unsigned long long {
+			size_t calls = 0;
+			return skipSubtrees(img, calls);
+		});
+	}
+	bench("decodeLocation", locations.size(), []() -> unsigned long long {
+		unsigned long long sum = 0;
+		for (size_t i = 0; i < locations.size(); i++)
+		{
+			Location loc = decodeLocation(locations[i], &frameBases[i]);
+			sum += loc.type + loc.off;
+		}
+		return sum;
+	});
+	bench("dsym2c", pnames.size(), []() -> unsigned long long {
+		unsigned long long sum = 0;
+		for (size_t i = 0; i < pnames.size(); i++)
+		{
+			const BYTE* p = &pnames[i][0];
+			int len = pstrlen(p);
+			sum += dsym2c(p, len, cname, sizeof(cname));
+		}
+		return sum;
+	});
+	bench("p2c", pnames.size(), []() -> unsigned long long {
+		unsigned long long sum = 0;
+		for (size_t i = 0; i < pnames.size(); i++)
+			sum += p2c(&pnames[i][0])[0];
+		return sum;
+	});
+	bench("pstrcpy_v (v2)", pnames.size(), []() -> unsigned long long {
+		unsigned long long sum = 0;
+		for (size_t i = 0; i < pnames.size(); i++)
+			sum += pstrcpy_v(false, buf, &pnames[i][0]);
+		return sum;
+	});
+	bench("pstrcpy_v (v3)", pnames.size(), []() -> unsigned long long {
+		unsigned long long sum = 0;
+		for (size_t i = 0; i < pnames.size(); i++)
+			sum += pstrcpy_v(true, buf, &pnames[i][0]);
+		return sum;
+	});
+	bench("cstrcpy_v (v3)", names.size(), []() -> unsigned long long {
+		unsigned long long sum = 0;
+		for (size_t i = 0; i < names.size(); i++)
+			sum += cstrcpy_v(true, buf, names[i].c_str());
+		return sum;
+	});
+	bench("d_demangle", mangled.size(), []() -> unsigned long long {
+		unsigned long long sum = 0;
+		for (size_t i = 0; i < mangled.size(); i++)
+			sum += d_demangle(mangled[i].c_str(), cname, sizeof(cname), true);
+		return sum;
+	});
+
+	return 0;
+}